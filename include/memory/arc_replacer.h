@@ -0,0 +1,65 @@
+#ifndef ARC_REPLACER_H
+#define ARC_REPLACER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ghost_pool.h"
+#include "index_list.h"
+#include "replacer.h"
+
+//===----------------------------------------------------------------------===//
+// ARC Replacer statement
+//===----------------------------------------------------------------------===//
+// Adaptive Replacement Cache (Megiddo and Modha, FAST 2003). Resident pages seen once are on T1 and pages seen
+// at least twice are on T2, both in LRU order. Pages evicted from T1 and T2 are remembered on the ghost lists
+// B1 and B2, and a hit on a ghost moves the target size of T1 towards the list that would have kept the page.
+typedef struct ArcReplacer {
+  IndexLink *frame_links_;  // Links of every frame on T1 or T2
+  uint8_t *frame_state_;    // List and evictable bit of every frame, indexed by frame id
+  page_id_t *frame_pages_;  // Page resident in every frame, -1 if the page wasn't admitted
+  IndexList t1_;            // Resident pages accessed once
+  IndexList t2_;            // Resident pages accessed at least twice
+  IndexList b1_;            // Pages evicted from T1
+  IndexList b2_;            // Pages evicted from T2
+  GhostPool ghosts_;        // Pages on B1 and B2, at most replacer_size_ of them
+  size_t t1_target_;        // Adaptive target size of T1
+  size_t curr_size_;        // The number of evictable frames
+  size_t replacer_size_;    // Maximum number of frames in the replacer
+} ArcReplacer;
+
+// Initialize the replacer
+ArcReplacer *ArcReplacerInit(size_t num_frames);
+
+// Destroy the replacer to avoid memory leak
+void ArcReplacerDestroy(ArcReplacer *replacer);
+
+// Evict the least recently used evictable frame of T1 if T1 exceeds its target, otherwise of T2
+bool ArcReplacerEvict(ArcReplacer *replacer, frame_id_t *frame_id);
+
+// Record the access of a frame, which moves it to the front of T2
+void ArcReplacerRecordAccess(ArcReplacer *replacer, frame_id_t frame_id);
+
+// Toggle whether a frame is evictable or non-evictable
+void ArcReplacerSetEvictable(ArcReplacer *replacer, frame_id_t frame_id, bool set_evictable);
+
+// Record the access that faulted a page into a frame, the page goes to T2 if it is a ghost and to T1 otherwise
+void ArcReplacerAdmit(ArcReplacer *replacer, frame_id_t frame_id, page_id_t page_id);
+
+// Record a hit on every frame in order, the same as RecordAccess followed by SetEvictable(true) on each of them
+void ArcReplacerRecordHits(ArcReplacer *replacer, const frame_id_t *frame_ids, size_t n);
+
+// Return replacer's size, which tracks the number of evictable frames
+size_t ArcReplacerSize(ArcReplacer *replacer);
+
+// Return the bytes of memory the replacer holds, the replacer itself included
+size_t ArcReplacerMemoryUsage(ArcReplacer *replacer);
+//===----------------------------------------------------------------------===//
+// Replacer interface statement
+//===----------------------------------------------------------------------===//
+extern const ReplacerVTable ArcReplacerVTable;
+
+static inline AnyReplacer ArcReplacerAsAny(ArcReplacer *replacer) {
+  return (AnyReplacer){.self = replacer, .vtable = &ArcReplacerVTable};
+}
+#endif
@@ -1,59 +1,40 @@
 #ifndef BUFFER_MANAGER_H
 #define BUFFER_MANAGER_H
 #include <stddef.h>
+#include "buffer_stats.h"
+#include "page_store.h"
+#include "page_table.h"
+#include "prefetcher.h"
 #include "replacer.h"
 
-typedef int32_t page_id_t;
+// How many pages ahead FetchPages prefetches the page table
+#define PAGE_TABLE_PREFETCH_DISTANCE 8
 
-#define i_type FreeList
-#define i_key frame_id_t
-#include "stc/clist.h"
-
-#define i_type PageTable
-#define i_key page_id_t
-#define i_val frame_id_t
-#include "stc/cmap.h"
+//===----------------------------------------------------------------------===//
+// BufferManager statement
+//===----------------------------------------------------------------------===//
+// Buffer manager whose replacement policy is chosen at runtime, e.g.
+// BufferManagerInit(pool_size, ReplacerAsAny(ReplacerInit(pool_size, k)))
+#define i_type BufferManager
+#define i_replacer AnyReplacer
+#define i_replacer_handle AnyReplacer
+#include "memory/buffer_manager_template.h"
 
 //===----------------------------------------------------------------------===//
 // LRUBufferManager statement
 //===----------------------------------------------------------------------===//
-typedef struct LRUBufferManager {
-  size_t pool_size;
-  size_t capacity_miss_num_;    // The number of evictions
-  size_t compulsory_miss_num_;  // The number of misses that are compulsory
-  FreeList free_list_;
-  PageTable page_table_;
-  Replacer *replacer_;
-  page_id_t *pages_;
-} LRUBufferManager;
-
-LRUBufferManager *LRUBufferManagerInit(size_t pool_size, size_t replacer_k);
-
-void LRUBufferManagerDestroy(LRUBufferManager *manager);
+// Buffer manager fixed to the LRU-K replacer, its replacer calls are direct and FetchPage can be inlined
+#define i_type LRUBufferManager
+#define i_replacer Replacer
+#define i_static
+#include "memory/buffer_manager_template.h"
 
-// Fetch a page from the buffer manager
-frame_id_t LRUBufferManagerFetchPage(LRUBufferManager *manager, page_id_t pid);
-
-void LRUBufferManagerGetMissNum(LRUBufferManager *manager, size_t *compulsory_miss_num, size_t *capacity_miss_num);
 //===----------------------------------------------------------------------===//
 // FIFOBufferManager statement
 //===----------------------------------------------------------------------===//
-typedef struct FIFOBufferManager {
-  size_t pool_size;
-  size_t capacity_miss_num_;    // The number of evictions
-  size_t compulsory_miss_num_;  // The number of misses that are compulsory
-  FreeList free_list_;
-  PageTable page_table_;
-  FIFOReplacer *replacer_;
-  page_id_t *pages_;
-} FIFOBufferManager;
-
-FIFOBufferManager *FIFOBufferManagerInit(size_t pool_size);
-
-void FIFOBufferManagerDestroy(FIFOBufferManager *manager);
-
-// Fetch a page from the buffer manager
-frame_id_t FIFOBufferManagerFetchPage(FIFOBufferManager *manager, page_id_t pid);
-
-void FIFOBufferManagerGetMissNum(FIFOBufferManager *manager, size_t *compulsory_miss_num, size_t *capacity_miss_num);
+// Buffer manager fixed to the FIFO replacer, its replacer calls are direct and FetchPage can be inlined
+#define i_type FIFOBufferManager
+#define i_replacer FIFOReplacer
+#define i_static
+#include "memory/buffer_manager_template.h"
 #endif
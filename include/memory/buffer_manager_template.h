@@ -0,0 +1,507 @@
+// Buffer manager template. Every buffer manager shares this page-fetching logic and only differs in the
+// replacer it drives, so it is instantiated once per replacer in the STC style:
+//
+//   #define i_type LRUBufferManager        // generated type, also the prefix of its functions
+//   #define i_replacer Replacer            // prefix of the replacer functions, e.g. ReplacerEvict
+//   #define i_replacer_handle Replacer *   // how the replacer is stored, defaults to i_replacer *
+//   #define i_static                       // optional: define every function static inline in this file
+//   #include "memory/buffer_manager_template.h"
+//
+// Without i_static only the type and the declarations are emitted, and exactly one translation unit must
+// include the template again with i_implement defined to emit the definitions.
+// The replacer must provide Evict, Admit, RecordAccess, RecordHits, SetEvictable, MemoryUsage and Destroy functions
+// with that prefix.
+// "memory/buffer_manager.h" must be included first for PageTable, PageStore, Prefetcher and BufferStats.
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stc/ccommon.h"
+
+#ifndef i_type
+#error "i_type must be defined before including buffer_manager_template.h"
+#endif
+#ifndef i_replacer
+#error "i_replacer must be defined before including buffer_manager_template.h"
+#endif
+#ifndef i_replacer_handle
+#define i_replacer_handle i_replacer *
+#endif
+
+#define _bm_MEMB(name) c_JOIN(i_type, name)
+#define _bm_REPL(name) c_JOIN(i_replacer, name)
+#ifdef i_static
+#define _bm_API static inline
+#else
+#define _bm_API
+#endif
+
+#ifndef i_implement
+typedef struct i_type {
+  size_t pool_size;
+  size_t capacity_miss_num_;    // The number of misses that evicted a page
+  size_t compulsory_miss_num_;  // The number of misses that are compulsory
+  size_t hit_num_;              // The number of accesses that found their page resident
+  size_t failed_fetch_num_;     // Misses that found every frame pinned
+  size_t eviction_num_;         // Evictions for a miss or a prefetch
+  size_t evict_call_num_;       // Calls of the replacer's Evict, every BUFFER_STATS_EVICT_SAMPLE_PERIOD-th is timed
+  frame_id_t *free_frames_;     // Stack of the frames that hold no page, the next one to use on top
+  size_t free_frame_num_;
+  PageTable *page_table_;
+  i_replacer_handle replacer_;
+  page_id_t *pages_;
+  uint32_t *pin_counts_;         // A frame is evictable only while its pin count is 0
+  PageStore *store_;             // NULL when the frames hold no data
+  uint8_t *data_;                // pool_size pages of the store's page size, the page of frame i at i * page size
+  bool *dirty_;                  // The frame was written since its page was read or flushed
+  Prefetcher *prefetcher_;       // NULL without read-ahead
+  page_id_t *prefetch_pages_;    // The pages the prefetcher asked for on the last access
+  bool *prefetched_;             // The frame was prefetched and not accessed since
+  page_id_t *prefetch_victims_;  // Pages evicted by a prefetch, indexed by page id modulo the pool size
+  PrefetchStats prefetch_stats_;
+  LatencyHistogram evict_latency_;
+} i_type;
+
+// Initialize the buffer manager, which takes the ownership of the replacer
+_bm_API i_type *_bm_MEMB(Init)(size_t pool_size, i_replacer_handle replacer);
+
+// Initialize a buffer manager whose frames hold the data of the pages in store. A page is read into its frame on a
+// miss, and a dirty victim is queued for write-back so the miss doesn't wait for the write. The store isn't owned.
+_bm_API i_type *_bm_MEMB(InitWithStore)(size_t pool_size, i_replacer_handle replacer, PageStore *store);
+
+// Write back every dirty page first when the frames hold data
+_bm_API void _bm_MEMB(Destroy)(i_type *manager);
+
+// Read ahead with the given prefetcher from now on, the buffer manager takes its ownership. Prefetched pages don't
+// count as misses, and at most a quarter of the pool is prefetched on one access.
+_bm_API void _bm_MEMB(SetPrefetcher)(i_type *manager, Prefetcher *prefetcher);
+
+// Fetch a page and pin it, -1 if the page isn't resident and every frame is pinned. The page can't be evicted until
+// it is unpinned as many times as it was fetched.
+_bm_API frame_id_t _bm_MEMB(FetchPage)(i_type *manager, page_id_t page_id);
+
+// FetchPage on behalf of a requester, whose accesses are the streams the prefetcher follows. FetchPage and
+// AccessPage are requester 0.
+_bm_API frame_id_t _bm_MEMB(FetchPageFrom)(i_type *manager, uint32_t requester, page_id_t page_id);
+
+// Release one pin of a page, false if the page isn't resident or isn't pinned
+_bm_API bool _bm_MEMB(UnpinPage)(i_type *manager, page_id_t page_id);
+
+// Access a page without keeping it pinned, the same as FetchPage followed by UnpinPage
+_bm_API frame_id_t _bm_MEMB(AccessPage)(i_type *manager, page_id_t page_id);
+
+_bm_API frame_id_t _bm_MEMB(AccessPageFrom)(i_type *manager, uint32_t requester, page_id_t page_id);
+
+// Access n pages in order into frame_ids, the same as n calls of AccessPage. The page table is probed once per page
+// while the home slots of the next pages are prefetched, and every run of hits goes to the replacer in one call.
+_bm_API void _bm_MEMB(FetchPages)(i_type *manager, const page_id_t *page_ids, size_t n, frame_id_t *frame_ids);
+
+_bm_API void _bm_MEMB(GetMissNum)(i_type *manager, size_t *compulsory_miss_num, size_t *capacity_miss_num);
+
+// All zero without a prefetcher
+_bm_API void _bm_MEMB(GetPrefetchStats)(i_type *manager, PrefetchStats *stats);
+
+// Everything the buffer manager counted, with the probe lengths of its page table and its memory footprint
+_bm_API void _bm_MEMB(GetStats)(i_type *manager, BufferStats *stats);
+
+// The data of the page in a frame, NULL without a store. It stays valid while the page is pinned.
+_bm_API uint8_t *_bm_MEMB(GetPageData)(i_type *manager, frame_id_t frame_id);
+
+// Mark a resident page as written, so it is written back before its frame is reused. False if it isn't resident.
+_bm_API bool _bm_MEMB(MarkDirty)(i_type *manager, page_id_t page_id);
+
+// Write a resident dirty page to the store and wait for it, false if it isn't resident or the write failed
+_bm_API bool _bm_MEMB(FlushPage)(i_type *manager, page_id_t page_id);
+
+// Write every dirty page to the store and wait for them, false if a write failed
+_bm_API bool _bm_MEMB(FlushAllPages)(i_type *manager);
+#endif
+
+#if defined i_implement || defined i_static
+_bm_API i_type *_bm_MEMB(Init)(size_t pool_size, i_replacer_handle replacer) {
+  i_type *manager = (i_type *)malloc(sizeof(i_type));
+  manager->pool_size = pool_size;
+  manager->capacity_miss_num_ = 0;
+  manager->compulsory_miss_num_ = 0;
+  manager->hit_num_ = 0;
+  manager->failed_fetch_num_ = 0;
+  manager->eviction_num_ = 0;
+  manager->evict_call_num_ = 0;
+  memset(&manager->evict_latency_, 0, sizeof(manager->evict_latency_));
+  manager->free_frames_ = (frame_id_t *)malloc(sizeof(frame_id_t) * pool_size);
+  manager->free_frame_num_ = pool_size;
+  manager->page_table_ = PageTableInit(pool_size);
+  manager->pages_ = (page_id_t *)malloc(sizeof(page_id_t) * pool_size);
+  manager->pin_counts_ = (uint32_t *)calloc(pool_size, sizeof(uint32_t));
+  manager->replacer_ = replacer;
+  manager->store_ = NULL;
+  manager->data_ = NULL;
+  manager->dirty_ = NULL;
+  manager->prefetcher_ = NULL;
+  manager->prefetch_pages_ = NULL;
+  manager->prefetched_ = NULL;
+  manager->prefetch_victims_ = NULL;
+  manager->prefetch_stats_ = (PrefetchStats){0, 0, 0, 0};
+
+  // Initially, every frame is free. They are stacked in reverse so frames are used from 0 up.
+  for (size_t i = 0; i < pool_size; ++i) {
+    manager->free_frames_[i] = (frame_id_t)(pool_size - 1 - i);
+  }
+
+  return manager;
+}
+
+_bm_API i_type *_bm_MEMB(InitWithStore)(size_t pool_size, i_replacer_handle replacer, PageStore *store) {
+  i_type *manager = _bm_MEMB(Init)(pool_size, replacer);
+  manager->store_ = store;
+  manager->data_ = (uint8_t *)malloc(pool_size * store->page_size_);
+  manager->dirty_ = (bool *)calloc(pool_size, sizeof(bool));
+  return manager;
+}
+
+_bm_API void _bm_MEMB(Destroy)(i_type *manager) {
+  if (manager->store_ != NULL) {
+    _bm_MEMB(FlushAllPages)(manager);
+    free(manager->data_);
+    free(manager->dirty_);
+  }
+  if (manager->prefetcher_ != NULL) {
+    PrefetcherDestroy(manager->prefetcher_);
+    free(manager->prefetch_pages_);
+    free(manager->prefetched_);
+    free(manager->prefetch_victims_);
+  }
+  free(manager->free_frames_);
+  PageTableDestroy(manager->page_table_);
+  _bm_REPL(Destroy)(manager->replacer_);
+  free(manager->pages_);
+  free(manager->pin_counts_);
+  free(manager);
+}
+
+static inline uint8_t *_bm_MEMB(FrameData_)(i_type *manager, frame_id_t frame_id) {
+  return manager->data_ + (size_t)frame_id * manager->store_->page_size_;
+}
+
+_bm_API void _bm_MEMB(SetPrefetcher)(i_type *manager, Prefetcher *prefetcher) {
+  manager->prefetcher_ = prefetcher;
+  const size_t degree = prefetcher->degree_ > 0 ? prefetcher->degree_ : 1;
+  manager->prefetch_pages_ = (page_id_t *)malloc(sizeof(page_id_t) * degree);
+  manager->prefetched_ = (bool *)calloc(manager->pool_size, sizeof(bool));
+  manager->prefetch_victims_ = (page_id_t *)malloc(sizeof(page_id_t) * manager->pool_size);
+  for (size_t i = 0; i < manager->pool_size; ++i) {
+    manager->prefetch_victims_[i] = -1;
+  }
+}
+
+// Evict a frame through the replacer, timing a sample of the calls
+static inline bool _bm_MEMB(Evict_)(i_type *manager, frame_id_t *frame_id) {
+  bool evicted;
+  if (manager->evict_call_num_++ % BUFFER_STATS_EVICT_SAMPLE_PERIOD != 0) {
+    evicted = _bm_REPL(Evict)(manager->replacer_, frame_id);
+  } else {
+    const uint64_t start = LatencyNow();
+    evicted = _bm_REPL(Evict)(manager->replacer_, frame_id);
+    LatencyHistogramRecord(&manager->evict_latency_, LatencyNow() - start);
+  }
+  if (evicted) {
+    manager->eviction_num_++;
+  }
+  return evicted;
+}
+
+// Take a frame for a page that isn't in the page table and map the page to it, -1 if no frame can be evicted.
+// empty_slot is the slot the page table lookup of the page ended at. The evicted page is stored into victim, -1 when
+// a free frame was used. The replacer isn't told about the page yet.
+static inline frame_id_t _bm_MEMB(LoadPage_)(i_type *manager, page_id_t page_id, size_t empty_slot,
+                                             page_id_t *victim) {
+  frame_id_t frame_id;
+  if (manager->free_frame_num_ > 0) {
+    // Allocate a new frame from the top of the free stack
+    frame_id = manager->free_frames_[--manager->free_frame_num_];
+    if (manager->store_ != NULL) {
+      PageStoreRead(manager->store_, page_id, _bm_MEMB(FrameData_)(manager, frame_id));
+    }
+    PageTableInsertAt(manager->page_table_, empty_slot, page_id, frame_id);
+    *victim = -1;
+  } else if (_bm_MEMB(Evict_)(manager, &frame_id)) {
+    // Free list is empty, should evict a existing frame. Only unpinned frames are evictable, so this fails when
+    // every frame is pinned.
+    *victim = manager->pages_[frame_id];
+    if (manager->store_ != NULL) {
+      // The victim is copied into the write-back queue, so the frame can take the new page right away
+      uint8_t *data = _bm_MEMB(FrameData_)(manager, frame_id);
+      if (manager->dirty_[frame_id]) {
+        PageStoreWriteAsync(manager->store_, *victim, data);
+        manager->dirty_[frame_id] = false;
+      }
+      PageStoreRead(manager->store_, page_id, data);
+    }
+    if (manager->prefetched_ != NULL && manager->prefetched_[frame_id]) {
+      manager->prefetched_[frame_id] = false;
+      manager->prefetch_stats_.wasted_num_++;
+    }
+    PageTableReplace(manager->page_table_, *victim, page_id, frame_id, empty_slot);
+  } else {
+    return -1;
+  }
+  manager->pages_[frame_id] = page_id;
+  return frame_id;
+}
+
+// Bring a page that isn't in the page table into a frame, pinned or evictable, -1 if no frame can be evicted
+static inline frame_id_t _bm_MEMB(FetchMissingPage_)(i_type *manager, page_id_t page_id, size_t empty_slot, bool pin) {
+  if (manager->prefetcher_ != NULL) {
+    page_id_t *victim = &manager->prefetch_victims_[(uint32_t)page_id % manager->pool_size];
+    if (*victim == page_id) {
+      *victim = -1;
+      manager->prefetch_stats_.pollution_miss_num_++;
+    }
+  }
+  page_id_t victim;
+  const frame_id_t frame_id = _bm_MEMB(LoadPage_)(manager, page_id, empty_slot, &victim);
+  if (frame_id == -1) {
+    manager->failed_fetch_num_++;
+    return -1;
+  }
+  _bm_REPL(Admit)(manager->replacer_, frame_id, page_id);
+  if (pin) {
+    manager->pin_counts_[frame_id] = 1;
+  } else {
+    _bm_REPL(SetEvictable)(manager->replacer_, frame_id, true);
+  }
+  if (victim == -1) {
+    manager->compulsory_miss_num_++;
+  } else {
+    manager->capacity_miss_num_++;
+  }
+  return frame_id;
+}
+
+// Bring in the pages the prefetcher asks for after an access, as evictable pages
+static inline void _bm_MEMB(Prefetch_)(i_type *manager, uint32_t requester, page_id_t page_id) {
+  const size_t prefetch_num = PrefetcherObserve(manager->prefetcher_, requester, page_id, manager->prefetch_pages_);
+  size_t issued_num = 0;
+  for (size_t i = 0; i < prefetch_num && issued_num < manager->pool_size / 4; ++i) {
+    const page_id_t prefetch_page_id = manager->prefetch_pages_[i];
+    size_t empty_slot = 0;
+    if (PageTableFindForInsert(manager->page_table_, prefetch_page_id, &empty_slot) != -1) {
+      continue;
+    }
+    page_id_t victim;
+    const frame_id_t frame_id = _bm_MEMB(LoadPage_)(manager, prefetch_page_id, empty_slot, &victim);
+    if (frame_id == -1) {
+      return;
+    }
+    if (victim != -1) {
+      manager->prefetch_victims_[(uint32_t)victim % manager->pool_size] = victim;
+    }
+    _bm_REPL(Admit)(manager->replacer_, frame_id, prefetch_page_id);
+    _bm_REPL(SetEvictable)(manager->replacer_, frame_id, true);
+    manager->prefetched_[frame_id] = true;
+    manager->prefetch_stats_.issued_num_++;
+    issued_num++;
+  }
+}
+
+_bm_API frame_id_t _bm_MEMB(FetchPageFrom)(i_type *manager, uint32_t requester, page_id_t page_id) {
+  // Given page_id is in the page table
+  size_t empty_slot = 0;
+  frame_id_t frame_id = PageTableFindForInsert(manager->page_table_, page_id, &empty_slot);
+  if (frame_id != -1) {
+    manager->hit_num_++;
+    _bm_REPL(RecordAccess)(manager->replacer_, frame_id);
+    if (manager->pin_counts_[frame_id]++ == 0) {
+      _bm_REPL(SetEvictable)(manager->replacer_, frame_id, false);
+    }
+    if (manager->prefetched_ != NULL && manager->prefetched_[frame_id]) {
+      manager->prefetched_[frame_id] = false;
+      manager->prefetch_stats_.hit_num_++;
+    }
+  } else {
+    frame_id = _bm_MEMB(FetchMissingPage_)(manager, page_id, empty_slot, true);
+  }
+  // The page is pinned, so the prefetches can't evict it
+  if (frame_id != -1 && manager->prefetcher_ != NULL) {
+    _bm_MEMB(Prefetch_)(manager, requester, page_id);
+  }
+  return frame_id;
+}
+
+_bm_API frame_id_t _bm_MEMB(FetchPage)(i_type *manager, page_id_t page_id) {
+  return _bm_MEMB(FetchPageFrom)(manager, 0, page_id);
+}
+
+_bm_API bool _bm_MEMB(UnpinPage)(i_type *manager, page_id_t page_id) {
+  const frame_id_t frame_id = PageTableFind(manager->page_table_, page_id);
+  if (frame_id == -1 || manager->pin_counts_[frame_id] == 0) {
+    return false;
+  }
+  if (--manager->pin_counts_[frame_id] == 0) {
+    _bm_REPL(SetEvictable)(manager->replacer_, frame_id, true);
+  }
+  return true;
+}
+
+// Access a page without a prefetcher once the page table was looked up, frame_id is the frame it found and
+// empty_slot where the lookup ended on a miss
+static inline frame_id_t _bm_MEMB(AccessPageWithFrame_)(i_type *manager, page_id_t page_id, frame_id_t frame_id,
+                                                        size_t empty_slot) {
+  if (frame_id != -1) {
+    manager->hit_num_++;
+    _bm_REPL(RecordAccess)(manager->replacer_, frame_id);
+    // A page pinned by someone else stays pinned
+    if (manager->pin_counts_[frame_id] == 0) {
+      _bm_REPL(SetEvictable)(manager->replacer_, frame_id, true);
+    }
+    return frame_id;
+  }
+  return _bm_MEMB(FetchMissingPage_)(manager, page_id, empty_slot, false);
+}
+
+_bm_API frame_id_t _bm_MEMB(AccessPageFrom)(i_type *manager, uint32_t requester, page_id_t page_id) {
+  if (manager->prefetcher_ != NULL) {
+    // Pinned while the prefetches run
+    const frame_id_t frame_id = _bm_MEMB(FetchPageFrom)(manager, requester, page_id);
+    if (frame_id != -1) {
+      _bm_MEMB(UnpinPage)(manager, page_id);
+    }
+    return frame_id;
+  }
+  size_t empty_slot = 0;
+  const frame_id_t frame_id = PageTableFindForInsert(manager->page_table_, page_id, &empty_slot);
+  return _bm_MEMB(AccessPageWithFrame_)(manager, page_id, frame_id, empty_slot);
+}
+
+_bm_API frame_id_t _bm_MEMB(AccessPage)(i_type *manager, page_id_t page_id) {
+  return _bm_MEMB(AccessPageFrom)(manager, 0, page_id);
+}
+
+_bm_API void _bm_MEMB(FetchPages)(i_type *manager, const page_id_t *page_ids, size_t n, frame_id_t *frame_ids) {
+  if (manager->prefetcher_ != NULL) {
+    // Every access may prefetch
+    for (size_t i = 0; i < n; ++i) {
+      frame_ids[i] = _bm_MEMB(AccessPage)(manager, page_ids[i]);
+    }
+    return;
+  }
+  // Hits since the last miss, a miss hands them to the replacer first so it sees every access in order
+  size_t hit_begin = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (i + PAGE_TABLE_PREFETCH_DISTANCE < n) {
+      PageTablePrefetch(manager->page_table_, page_ids[i + PAGE_TABLE_PREFETCH_DISTANCE]);
+    }
+    size_t empty_slot = 0;
+    frame_ids[i] = PageTableFindForInsert(manager->page_table_, page_ids[i], &empty_slot);
+    if (frame_ids[i] != -1 && manager->pin_counts_[frame_ids[i]] == 0) {
+      continue;
+    }
+    if (i > hit_begin) {
+      _bm_REPL(RecordHits)(manager->replacer_, frame_ids + hit_begin, i - hit_begin);
+      manager->hit_num_ += i - hit_begin;
+    }
+    // A miss, or a hit on a pinned page that must not become evictable. The lookup isn't repeated.
+    frame_ids[i] = _bm_MEMB(AccessPageWithFrame_)(manager, page_ids[i], frame_ids[i], empty_slot);
+    hit_begin = i + 1;
+  }
+  if (n > hit_begin) {
+    _bm_REPL(RecordHits)(manager->replacer_, frame_ids + hit_begin, n - hit_begin);
+    manager->hit_num_ += n - hit_begin;
+  }
+}
+
+_bm_API void _bm_MEMB(GetMissNum)(i_type *manager, size_t *compulsory_miss_num, size_t *capacity_miss_num) {
+  *compulsory_miss_num = manager->compulsory_miss_num_;
+  *capacity_miss_num = manager->capacity_miss_num_;
+}
+
+_bm_API void _bm_MEMB(GetPrefetchStats)(i_type *manager, PrefetchStats *stats) {
+  *stats = manager->prefetch_stats_;
+}
+
+_bm_API void _bm_MEMB(GetStats)(i_type *manager, BufferStats *stats) {
+  stats->hit_num_ = manager->hit_num_;
+  stats->compulsory_miss_num_ = manager->compulsory_miss_num_;
+  stats->capacity_miss_num_ = manager->capacity_miss_num_;
+  stats->failed_fetch_num_ = manager->failed_fetch_num_;
+  stats->access_num_ = stats->hit_num_ + stats->compulsory_miss_num_ + stats->capacity_miss_num_ +
+                       stats->failed_fetch_num_;
+  stats->eviction_num_ = manager->eviction_num_;
+
+  const LatencyHistogram *latency = &manager->evict_latency_;
+  stats->evict_sample_num_ = (size_t)latency->count_;
+  stats->evict_mean_ns_ = latency->count_ > 0 ? (double)latency->total_ns_ / (double)latency->count_ : 0.0;
+  stats->evict_p50_ns_ = LatencyHistogramPercentile(latency, 0.5);
+  stats->evict_p99_ns_ = LatencyHistogramPercentile(latency, 0.99);
+  stats->evict_max_ns_ = (double)latency->max_ns_;
+
+  PageTableProbeStats(manager->page_table_, &stats->mean_probe_len_, &stats->max_probe_len_);
+  stats->page_table_bytes_ = PageTableMemoryUsage(manager->page_table_);
+  stats->replacer_bytes_ = _bm_REPL(MemoryUsage)(manager->replacer_);
+  stats->manager_bytes_ =
+      sizeof(i_type) + manager->pool_size * (sizeof(frame_id_t) + sizeof(page_id_t) + sizeof(uint32_t));
+  if (manager->store_ != NULL) {
+    stats->manager_bytes_ += manager->pool_size * (manager->store_->page_size_ + sizeof(bool));
+  }
+  if (manager->prefetcher_ != NULL) {
+    const Prefetcher *prefetcher = manager->prefetcher_;
+    const size_t degree = prefetcher->degree_ > 0 ? prefetcher->degree_ : 1;
+    stats->manager_bytes_ += sizeof(Prefetcher) + prefetcher->stream_num_ * sizeof(PrefetchStream) +
+                             degree * sizeof(page_id_t) + manager->pool_size * (sizeof(bool) + sizeof(page_id_t));
+  }
+  stats->prefetch_ = manager->prefetch_stats_;
+}
+
+_bm_API uint8_t *_bm_MEMB(GetPageData)(i_type *manager, frame_id_t frame_id) {
+  if (manager->store_ == NULL) {
+    return NULL;
+  }
+  return _bm_MEMB(FrameData_)(manager, frame_id);
+}
+
+_bm_API bool _bm_MEMB(MarkDirty)(i_type *manager, page_id_t page_id) {
+  const frame_id_t frame_id = PageTableFind(manager->page_table_, page_id);
+  if (frame_id == -1 || manager->store_ == NULL) {
+    return false;
+  }
+  manager->dirty_[frame_id] = true;
+  return true;
+}
+
+_bm_API bool _bm_MEMB(FlushPage)(i_type *manager, page_id_t page_id) {
+  const frame_id_t frame_id = PageTableFind(manager->page_table_, page_id);
+  if (frame_id == -1 || manager->store_ == NULL) {
+    return false;
+  }
+  // Written through the queue, an older queued write of the page must not land after this one
+  if (manager->dirty_[frame_id]) {
+    PageStoreWriteAsync(manager->store_, page_id, _bm_MEMB(FrameData_)(manager, frame_id));
+    manager->dirty_[frame_id] = false;
+  }
+  return PageStoreSync(manager->store_);
+}
+
+_bm_API bool _bm_MEMB(FlushAllPages)(i_type *manager) {
+  if (manager->store_ == NULL) {
+    return true;
+  }
+  // A free frame is never dirty
+  for (size_t i = 0; i < manager->pool_size; ++i) {
+    if (manager->dirty_[i]) {
+      PageStoreWriteAsync(manager->store_, manager->pages_[i], _bm_MEMB(FrameData_)(manager, (frame_id_t)i));
+      manager->dirty_[i] = false;
+    }
+  }
+  return PageStoreSync(manager->store_);
+}
+#endif
+
+#undef _bm_MEMB
+#undef _bm_REPL
+#undef _bm_API
+#undef i_type
+#undef i_replacer
+#undef i_replacer_handle
+#undef i_static
+#undef i_implement
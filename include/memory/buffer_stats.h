@@ -0,0 +1,87 @@
+#ifndef BUFFER_STATS_H
+#define BUFFER_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "prefetcher.h"
+
+//===----------------------------------------------------------------------===//
+// Latency Histogram statement
+//===----------------------------------------------------------------------===//
+// Log-linear histogram of latencies in nanoseconds. Every power of two is split into LATENCY_SUB_BUCKET_NUM buckets,
+// so a percentile read from it is within a quarter of the true value.
+#define LATENCY_SUB_BUCKET_BITS 2
+#define LATENCY_SUB_BUCKET_NUM (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_BUCKET_NUM (64 * LATENCY_SUB_BUCKET_NUM)
+
+typedef struct LatencyHistogram {
+  uint64_t buckets_[LATENCY_BUCKET_NUM];
+  uint64_t count_;
+  uint64_t total_ns_;
+  uint64_t max_ns_;
+} LatencyHistogram;
+
+// Return the time of the monotonic clock in nanoseconds, which a change of the wall clock doesn't step
+uint64_t LatencyNow(void);
+
+static inline size_t LatencyBucket(uint64_t ns) {
+  if (ns < LATENCY_SUB_BUCKET_NUM) {
+    return (size_t)ns;
+  }
+#if defined __GNUC__ || defined __clang__
+  const int top_bit = 63 - __builtin_clzll(ns);
+#else
+  int top_bit = 0;
+  for (uint64_t rest = ns >> 1; rest != 0; rest >>= 1) {
+    top_bit++;
+  }
+#endif
+  // The bits right below the top bit pick the bucket within its power of two
+  const size_t sub_bucket = (size_t)(ns >> (top_bit - LATENCY_SUB_BUCKET_BITS)) & (LATENCY_SUB_BUCKET_NUM - 1);
+  return (size_t)(top_bit - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKET_NUM + sub_bucket;
+}
+
+static inline void LatencyHistogramRecord(LatencyHistogram *histogram, uint64_t ns) {
+  histogram->buckets_[LatencyBucket(ns)]++;
+  histogram->count_++;
+  histogram->total_ns_ += ns;
+  if (ns > histogram->max_ns_) {
+    histogram->max_ns_ = ns;
+  }
+}
+
+// Return the latency below which the given fraction of the samples fall, rounded up to the end of its bucket. 0 for
+// an empty histogram.
+double LatencyHistogramPercentile(const LatencyHistogram *histogram, double fraction);
+
+//===----------------------------------------------------------------------===//
+// Buffer Stats statement
+//===----------------------------------------------------------------------===//
+// What a buffer manager counted since its initialization. Evictions are timed on a sample of them, reading the clock
+// around every eviction would cost more than most evictions do.
+#define BUFFER_STATS_EVICT_SAMPLE_PERIOD 16
+
+typedef struct BufferStats {
+  size_t access_num_;  // Every fetch, the sum of the hits, the misses and the failed fetches
+  size_t hit_num_;
+  size_t compulsory_miss_num_;
+  size_t capacity_miss_num_;
+  size_t failed_fetch_num_;  // Fetches of a page that wasn't resident while every frame was pinned
+  size_t eviction_num_;      // Evictions for a miss or a prefetch
+  size_t evict_sample_num_;  // Evictions that were timed
+  double evict_mean_ns_;
+  double evict_p50_ns_;
+  double evict_p99_ns_;
+  double evict_max_ns_;
+  double mean_probe_len_;  // Probe lengths of the pages in the page table, see PageTableProbeStats
+  size_t max_probe_len_;
+  size_t page_table_bytes_;
+  size_t replacer_bytes_;
+  size_t manager_bytes_;  // The buffer manager with its frames and prefetcher, without the page table and replacer
+  PrefetchStats prefetch_;
+} BufferStats;
+
+// Write the stats of a replay of a policy on frames_num frames as one line of JSON
+void BufferStatsWriteJson(FILE *file, const char *policy_name, size_t frames_num, const BufferStats *stats);
+#endif
@@ -0,0 +1,120 @@
+#ifndef CLOCK_REPLACER_H
+#define CLOCK_REPLACER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "replacer.h"
+
+//===----------------------------------------------------------------------===//
+// CLOCK Replacer statement
+//===----------------------------------------------------------------------===//
+typedef struct ClockReplacer {
+  uint8_t *frame_state_;  // Present, evictable and reference bits of every frame, indexed by frame id
+  size_t hand_;           // The frame the clock hand points to
+  size_t curr_size_;      // The number of evictable frames
+  size_t replacer_size_;  // Maximum number of frames in the replacer
+} ClockReplacer;
+
+// Initialize the replacer
+ClockReplacer *ClockReplacerInit(size_t num_frames);
+
+// Destroy the replacer to avoid memory leak
+void ClockReplacerDestroy(ClockReplacer *replacer);
+
+// Sweep the hand, clearing reference bits, until it reaches an evictable frame that is not referenced
+bool ClockReplacerEvict(ClockReplacer *replacer, frame_id_t *frame_id);
+
+// Record the access of a frame by setting its reference bit
+void ClockReplacerRecordAccess(ClockReplacer *replacer, frame_id_t frame_id);
+
+// Toggle whether a frame is evictable or non-evictable
+void ClockReplacerSetEvictable(ClockReplacer *replacer, frame_id_t frame_id, bool set_evictable);
+
+// Record the access that faulted a page into a frame, CLOCK doesn't depend on page identity so the page is ignored
+void ClockReplacerAdmit(ClockReplacer *replacer, frame_id_t frame_id, page_id_t page_id);
+
+// Record a hit on every frame in order, the same as RecordAccess followed by SetEvictable(true) on each of them
+void ClockReplacerRecordHits(ClockReplacer *replacer, const frame_id_t *frame_ids, size_t n);
+
+// Return replacer's size, which tracks the number of evictable frames
+size_t ClockReplacerSize(ClockReplacer *replacer);
+
+// Return the bytes of memory the replacer holds, the replacer itself included
+size_t ClockReplacerMemoryUsage(ClockReplacer *replacer);
+//===----------------------------------------------------------------------===//
+// CLOCK-Pro Replacer statement
+//===----------------------------------------------------------------------===//
+// CLOCK-Pro (Jiang, Chen and Zhang, USENIX ATC 2005) keeps resident hot and cold pages plus the metadata of
+// recently evicted cold pages on one clock. A cold page that is re-accessed during its test period becomes hot,
+// so pages touched once by a scan never displace the hot working set, similar to LRU-2.
+#define i_type ClockProGhostTable
+#define i_key page_id_t
+#define i_val int32_t
+#include "stc/cmap.h"
+
+typedef struct ClockProEntry {
+  page_id_t page_id_;  // -1 if the page is unknown because the buffer manager didn't admit it
+  frame_id_t fid_;     // -1 if the page is no longer resident
+  int32_t prev_;       // Neighbours on the clock
+  int32_t next_;
+  uint8_t flags_;
+} ClockProEntry;
+
+typedef struct ClockProReplacer {
+  ClockProEntry *entries_;   // Resident and non-resident pages, at most two per frame
+  int32_t *frame_entry_;     // Entry of the page resident in every frame, -1 if none
+  int32_t *free_entries_;    // Stack of unused entries
+  size_t free_entry_num_;
+  ClockProGhostTable ghost_table_;  // Entries of non-resident pages in their test period, by page id
+  int32_t hand_hot_;
+  int32_t hand_cold_;
+  int32_t hand_test_;
+  size_t hot_num_;             // The number of resident hot pages
+  size_t cold_evictable_num_;  // The number of resident cold pages that are evictable
+  size_t non_resident_num_;    // The number of non-resident pages in their test period
+  size_t cold_target_;         // Adaptive target for the number of resident cold pages
+  size_t curr_size_;           // The number of evictable frames
+  size_t replacer_size_;       // Maximum number of frames in the replacer
+} ClockProReplacer;
+
+// Initialize the replacer
+ClockProReplacer *ClockProReplacerInit(size_t num_frames);
+
+// Destroy the replacer to avoid memory leak
+void ClockProReplacerDestroy(ClockProReplacer *replacer);
+
+// Run the cold hand until it finds an evictable cold page that has not been referenced
+bool ClockProReplacerEvict(ClockProReplacer *replacer, frame_id_t *frame_id);
+
+// Record the access of a frame by setting its reference bit
+void ClockProReplacerRecordAccess(ClockProReplacer *replacer, frame_id_t frame_id);
+
+// Toggle whether a frame is evictable or non-evictable
+void ClockProReplacerSetEvictable(ClockProReplacer *replacer, frame_id_t frame_id, bool set_evictable);
+
+// Put a page faulted into a frame on the clock, as hot if it is re-accessed during its test period
+void ClockProReplacerAdmit(ClockProReplacer *replacer, frame_id_t frame_id, page_id_t page_id);
+
+// Record a hit on every frame in order, the same as RecordAccess followed by SetEvictable(true) on each of them
+void ClockProReplacerRecordHits(ClockProReplacer *replacer, const frame_id_t *frame_ids, size_t n);
+
+// Return replacer's size, which tracks the number of evictable frames
+size_t ClockProReplacerSize(ClockProReplacer *replacer);
+
+// Return the bytes of memory the replacer holds, the replacer itself included
+size_t ClockProReplacerMemoryUsage(ClockProReplacer *replacer);
+//===----------------------------------------------------------------------===//
+// Replacer interface statement
+//===----------------------------------------------------------------------===//
+extern const ReplacerVTable ClockReplacerVTable;
+extern const ReplacerVTable ClockProReplacerVTable;
+
+static inline AnyReplacer ClockReplacerAsAny(ClockReplacer *replacer) {
+  return (AnyReplacer){.self = replacer, .vtable = &ClockReplacerVTable};
+}
+
+static inline AnyReplacer ClockProReplacerAsAny(ClockProReplacer *replacer) {
+  return (AnyReplacer){.self = replacer, .vtable = &ClockProReplacerVTable};
+}
+#endif
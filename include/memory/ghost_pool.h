@@ -0,0 +1,83 @@
+#ifndef GHOST_POOL_H
+#define GHOST_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "index_list.h"
+#include "replacer.h"
+
+// Ids of recently evicted pages for the replacers that remember them (ARC's B1/B2, 2Q's A1out). The slots are
+// preallocated, each ghost sits on one IndexList owned by the replacer and is found by page id through a hash table.
+#define i_type GhostTable
+#define i_key page_id_t
+#define i_val int32_t
+#include "stc/cmap.h"
+
+typedef struct GhostPool {
+  page_id_t *pages_;  // Page of every slot
+  uint8_t *lists_;    // Tag of the list every slot is on, chosen by the replacer
+  IndexLink *links_;
+  int32_t *free_slots_;  // Stack of unused slots
+  size_t free_slot_num_;
+  GhostTable table_;  // Slot of every ghost, by page id
+  size_t capacity_;
+} GhostPool;
+
+static inline GhostPool GhostPoolInit(size_t capacity) {
+  GhostPool pool;
+  pool.pages_ = (page_id_t *)malloc(sizeof(page_id_t) * capacity);
+  pool.lists_ = (uint8_t *)malloc(sizeof(uint8_t) * capacity);
+  pool.links_ = (IndexLink *)malloc(sizeof(IndexLink) * capacity);
+  pool.free_slots_ = (int32_t *)malloc(sizeof(int32_t) * capacity);
+  for (size_t i = 0; i < capacity; ++i) {
+    pool.free_slots_[i] = (int32_t)(capacity - 1 - i);
+  }
+  pool.free_slot_num_ = capacity;
+  pool.table_ = GhostTable_with_capacity((intptr_t)capacity);
+  pool.capacity_ = capacity;
+  return pool;
+}
+
+// Return the bytes of memory the pool holds outside the GhostPool itself
+static inline size_t GhostPoolMemoryUsage(const GhostPool *pool) {
+  const size_t slot_size = sizeof(page_id_t) + sizeof(uint8_t) + sizeof(IndexLink) + sizeof(int32_t);
+  const size_t bucket_num = (size_t)pool->table_.bucket_count;
+  return pool->capacity_ * slot_size + bucket_num * sizeof(GhostTable_value) +
+         (bucket_num + 1) * sizeof(struct chash_slot);
+}
+
+static inline void GhostPoolDestroy(GhostPool *pool) {
+  free(pool->pages_);
+  free(pool->lists_);
+  free(pool->links_);
+  free(pool->free_slots_);
+  GhostTable_drop(&pool->table_);
+}
+
+// Return the slot of a ghost page, -1 if the page is not remembered
+static inline int32_t GhostPoolFind(const GhostPool *pool, page_id_t page_id) {
+  const GhostTable_value *ghost = GhostTable_get(&pool->table_, page_id);
+  return ghost == NULL ? -1 : ghost->second;
+}
+
+// Remember a page at the front of the given list
+static inline void GhostPoolPush(GhostPool *pool, IndexList *list, uint8_t list_tag, page_id_t page_id) {
+  const int32_t slot = pool->free_slots_[--pool->free_slot_num_];
+  pool->pages_[slot] = page_id;
+  pool->lists_[slot] = list_tag;
+  IndexListPushFront(list, pool->links_, slot);
+  GhostTable_insert(&pool->table_, page_id, slot);
+}
+
+// Forget the ghost in the given slot, which is on the given list
+static inline void GhostPoolRemove(GhostPool *pool, IndexList *list, int32_t slot) {
+  IndexListRemove(list, pool->links_, slot);
+  GhostTable_erase(&pool->table_, pool->pages_[slot]);
+  pool->free_slots_[pool->free_slot_num_++] = slot;
+}
+
+// Forget the least recently remembered ghost of a non-empty list
+static inline void GhostPoolPopBack(GhostPool *pool, IndexList *list) { GhostPoolRemove(pool, list, list->tail_); }
+#endif
@@ -0,0 +1,58 @@
+#ifndef INDEX_LIST_H
+#define INDEX_LIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Intrusive doubly linked list over the slots of an array. The links live in an array owned by the user and
+// indexed like the slots, so a slot can be moved or removed in O(1) without any allocation.
+// The front of a list is its most recently inserted slot.
+typedef struct IndexLink {
+  int32_t prev_;  // -1 if none
+  int32_t next_;  // -1 if none
+} IndexLink;
+
+typedef struct IndexList {
+  int32_t head_;  // -1 if the list is empty
+  int32_t tail_;  // -1 if the list is empty
+  size_t size_;
+} IndexList;
+
+static inline IndexList IndexListInit(void) { return (IndexList){.head_ = -1, .tail_ = -1, .size_ = 0}; }
+
+static inline void IndexListPushFront(IndexList *list, IndexLink *links, int32_t slot) {
+  links[slot].prev_ = -1;
+  links[slot].next_ = list->head_;
+  if (list->head_ == -1) {
+    list->tail_ = slot;
+  } else {
+    links[list->head_].prev_ = slot;
+  }
+  list->head_ = slot;
+  list->size_++;
+}
+
+static inline void IndexListRemove(IndexList *list, IndexLink *links, int32_t slot) {
+  if (links[slot].prev_ == -1) {
+    list->head_ = links[slot].next_;
+  } else {
+    links[links[slot].prev_].next_ = links[slot].next_;
+  }
+  if (links[slot].next_ == -1) {
+    list->tail_ = links[slot].prev_;
+  } else {
+    links[links[slot].next_].prev_ = links[slot].prev_;
+  }
+  links[slot].prev_ = -1;
+  links[slot].next_ = -1;
+  list->size_--;
+}
+
+// Move a slot of the list to its front
+static inline void IndexListMoveToFront(IndexList *list, IndexLink *links, int32_t slot) {
+  if (list->head_ != slot) {
+    IndexListRemove(list, links, slot);
+    IndexListPushFront(list, links, slot);
+  }
+}
+#endif
@@ -0,0 +1,19 @@
+#ifndef OPT_SIMULATOR_H
+#define OPT_SIMULATOR_H
+
+#include <stddef.h>
+#include "replacer.h"
+
+//===----------------------------------------------------------------------===//
+// OPT Simulator statement
+//===----------------------------------------------------------------------===//
+// Belady's MIN evicts the page whose next use lies farthest in the future. It needs the whole trace in advance,
+// so it can't back a buffer manager and only serves as the lower bound of the miss rate of the online policies.
+
+// Fill next_use[i] with the index of the next access to trace[i], access_num if the page isn't accessed again
+void OptComputeNextUse(const page_id_t *trace, size_t access_num, size_t *next_use);
+
+// Replay the trace on pool_size frames under OPT, misses are split the same way as the buffer manager splits them
+void OptSimulate(const page_id_t *trace, size_t access_num, size_t pool_size, size_t *compulsory_miss_num,
+                 size_t *capacity_miss_num);
+#endif
@@ -0,0 +1,57 @@
+#ifndef PAGE_STORE_H
+#define PAGE_STORE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "replacer.h"
+
+//===----------------------------------------------------------------------===//
+// Page Store statement
+//===----------------------------------------------------------------------===//
+// Pages of a fixed size stored back to back in a file, page i at offset i * page_size. Pages that were never written
+// read as zeros. Writes are queued and done by background threads with pwrite, so the caller only waits for the copy
+// into the queue. Every page always goes to the same writer, which keeps the writes of a page in order, and a read
+// takes the newest queued copy of the page before looking at the file.
+#define PAGE_STORE_QUEUE_SIZE 64
+
+// One background writer and its queue of pending writes
+typedef struct PageStoreWriter {
+  struct PageStore *store_;
+  pthread_t thread_;
+  pthread_mutex_t lock_;
+  pthread_cond_t not_empty_;
+  pthread_cond_t not_full_;
+  pthread_cond_t idle_;                        // Signaled whenever the queue becomes empty
+  page_id_t page_ids_[PAGE_STORE_QUEUE_SIZE];  // A ring of pending writes, the front one is being written
+  uint8_t *data_;                              // PAGE_STORE_QUEUE_SIZE pages, the data of every pending write
+  size_t head_;
+  size_t size_;
+  bool failed_;  // A write failed since the last sync
+  bool stop_;
+} PageStoreWriter;
+
+typedef struct PageStore {
+  int fd_;
+  size_t page_size_;
+  PageStoreWriter *writers_;
+  size_t writer_num_;
+} PageStore;
+
+// Open or create the file of a page store and start writer_num background writers, NULL if the file can't be opened
+PageStore *PageStoreOpen(const char *path, size_t page_size, size_t writer_num);
+
+// Finish the queued writes, stop the writers and close the file
+void PageStoreClose(PageStore *store);
+
+// Read a page into data, the newest queued write of the page if any. False if the file can't be read, data is then
+// zeroed.
+bool PageStoreRead(PageStore *store, page_id_t page_id, uint8_t *data);
+
+// Queue a copy of data to be written as a page, only waits when the page's writer has a full queue
+bool PageStoreWriteAsync(PageStore *store, page_id_t page_id, const uint8_t *data);
+
+// Wait until every queued write is on the file, false if any write failed since the last sync
+bool PageStoreSync(PageStore *store);
+#endif
@@ -0,0 +1,202 @@
+#ifndef PAGE_TABLE_H
+#define PAGE_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "replacer.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//===----------------------------------------------------------------------===//
+// Page Table statement
+//===----------------------------------------------------------------------===//
+// Open-addressing map from page id to frame id, sized once for the pool. Every slot has a control byte, which is
+// PAGE_TABLE_EMPTY or 7 bits of the page's hash, so a probe compares a whole group of control bytes at once
+// and only reads the slots whose bytes match. Groups are aligned, so a group load never straddles cache lines. Slots
+// are probed linearly from the home slot of the hash and removed by shifting the rest of the run back, so there are
+// no tombstones and a miss stops at the first empty byte.
+//
+// The sharded buffer manager looks pages up without its lock while the owner of the table changes it, so every store
+// to a control byte or a slot is atomic and PageTableFindConcurrent reads them atomically. Relaxed order is enough,
+// the caller's seqlock orders the reads against the stores. Relaxed stores compile to plain stores.
+#define PAGE_TABLE_GROUP_WIDTH 16
+#define PAGE_TABLE_GROUP_BITS UINT32_C(0xffff)  // One bit per control byte of a group
+#define PAGE_TABLE_EMPTY 0x80
+
+typedef struct PageTableSlot {
+  page_id_t page_id_;
+  frame_id_t frame_id_;
+} PageTableSlot;
+
+typedef struct PageTable {
+  uint8_t *ctrl_;  // One control byte per slot, aligned to the group width
+  PageTableSlot *slots_;
+  size_t mask_;      // Number of slots minus one, the number of slots is a power of two
+  size_t shift_;     // 64 minus log2 of the number of slots, the home slot is the top bits of the hash
+  size_t size_;      // Number of pages in the table
+  size_t capacity_;  // Maximum number of pages, the table is at most half full
+} PageTable;
+
+// Initialize the table for up to capacity pages
+PageTable *PageTableInit(size_t capacity);
+
+// Destroy the table to avoid memory leak
+void PageTableDestroy(PageTable *table);
+
+// Insert a page that isn't in the table
+void PageTableInsert(PageTable *table, page_id_t page_id, frame_id_t frame_id);
+
+// Insert a page into the empty slot a PageTableFindForInsert of it returned, the table must not have changed since
+void PageTableInsertAt(PageTable *table, size_t empty_slot, page_id_t page_id, frame_id_t frame_id);
+
+// Remove a page, false if it isn't in the table
+bool PageTableErase(PageTable *table, page_id_t page_id);
+
+// Move a frame from old_page_id, which must be in the table, to new_page_id, which must not. empty_slot is the slot a
+// PageTableFindForInsert of new_page_id returned. The slot is reused when it lies on the probe run of the new page,
+// otherwise this is an erase followed by an insert.
+void PageTableReplace(PageTable *table, page_id_t old_page_id, page_id_t new_page_id, frame_id_t frame_id,
+                      size_t empty_slot);
+
+// Return the number of pages in the table
+size_t PageTableSize(const PageTable *table);
+
+// Compute the mean and the longest probe length of the pages in the table, the number of slots from the home slot of
+// a page to its slot, both included. Both are 0 for an empty table.
+void PageTableProbeStats(const PageTable *table, double *mean_probe_len, size_t *max_probe_len);
+
+// Return the bytes of memory the table holds, the table itself included
+size_t PageTableMemoryUsage(const PageTable *table);
+
+// Fibonacci hashing, the top bits pick the home slot and bits below them the control byte
+static inline uint64_t PageTableHash(page_id_t page_id) { return (uint32_t)page_id * UINT64_C(0x9E3779B97F4A7C15); }
+
+static inline size_t PageTableHomeSlot(const PageTable *table, uint64_t hash) {
+  return (size_t)(hash >> table->shift_);
+}
+
+static inline uint8_t PageTableControlByte(uint64_t hash) { return (uint8_t)((hash >> 25) & 0x7f); }
+
+// Bit i is set iff the control byte at group[i] equals byte, group must be aligned to the group width
+static inline uint32_t PageTableGroupMatch(const uint8_t *group, uint8_t byte) {
+#ifdef __SSE2__
+  const __m128i ctrl = _mm_load_si128((const __m128i *)group);
+  return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)byte)));
+#else
+  uint32_t match = 0;
+  for (int i = 0; i < PAGE_TABLE_GROUP_WIDTH; ++i) {
+    match |= (uint32_t)(group[i] == byte) << i;
+  }
+  return match;
+#endif
+}
+
+static inline int PageTableLowestBit(uint32_t mask) {
+#if defined __GNUC__ || defined __clang__
+  return __builtin_ctz(mask);
+#else
+  int bit = 0;
+  while (!(mask & 1)) {
+    mask >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+// Relaxed atomic accesses to a control byte or a field of a slot, other compilers fall back to plain ones
+#if defined __GNUC__ || defined __clang__
+#define PAGE_TABLE_STORE(field, value) __atomic_store_n(&(field), (value), __ATOMIC_RELAXED)
+#define PAGE_TABLE_LOAD(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+#else
+#define PAGE_TABLE_STORE(field, value) ((field) = (value))
+#define PAGE_TABLE_LOAD(field) (field)
+#endif
+
+// Return the slot of a page, -1 if it isn't in the table. A miss stores the empty slot the probe ended at into
+// empty_slot unless it is NULL, an insert of the page would take that slot.
+static inline ptrdiff_t PageTableProbe(const PageTable *table, page_id_t page_id, size_t *empty_slot) {
+  const uint64_t hash = PageTableHash(page_id);
+  const uint8_t byte = PageTableControlByte(hash);
+  const size_t home = PageTableHomeSlot(table, hash);
+  // Most pages sit in their home slot at half load. Both of its addresses are known from the hash, so the two cache
+  // misses overlap, while the group probe can only read a slot after the control bytes arrive.
+  if (table->ctrl_[home] == byte && table->slots_[home].page_id_ == page_id) {
+    return (ptrdiff_t)home;
+  }
+  size_t pos = home & ~(size_t)(PAGE_TABLE_GROUP_WIDTH - 1);
+  // The probe starts at the home slot, in the middle of its group
+  uint32_t window = PAGE_TABLE_GROUP_BITS << (home & (PAGE_TABLE_GROUP_WIDTH - 1));
+  for (;;) {
+    const uint8_t *group = table->ctrl_ + pos;
+    for (uint32_t match = PageTableGroupMatch(group, byte) & window; match != 0; match &= match - 1) {
+      const size_t slot = pos + PageTableLowestBit(match);
+      if (table->slots_[slot].page_id_ == page_id) {
+        return (ptrdiff_t)slot;
+      }
+    }
+    // The table is never full, so every probe ends at an empty byte
+    const uint32_t empty = PageTableGroupMatch(group, PAGE_TABLE_EMPTY) & window;
+    if (empty != 0) {
+      if (empty_slot != NULL) {
+        *empty_slot = pos + PageTableLowestBit(empty);
+      }
+      return -1;
+    }
+    pos = (pos + PAGE_TABLE_GROUP_WIDTH) & table->mask_;
+    window = PAGE_TABLE_GROUP_BITS;
+  }
+}
+
+// Return the slot of a page, -1 if it isn't in the table
+static inline ptrdiff_t PageTableFindSlot(const PageTable *table, page_id_t page_id) {
+  return PageTableProbe(table, page_id, NULL);
+}
+
+// Return the frame of a page, -1 if it isn't in the table
+static inline frame_id_t PageTableFind(const PageTable *table, page_id_t page_id) {
+  const ptrdiff_t slot = PageTableFindSlot(table, page_id);
+  return slot == -1 ? -1 : table->slots_[slot].frame_id_;
+}
+
+// Return the frame of a page like PageTableFind, a miss also stores the empty slot an insert of the page would take,
+// so the insert doesn't probe again
+static inline frame_id_t PageTableFindForInsert(const PageTable *table, page_id_t page_id, size_t *empty_slot) {
+  const ptrdiff_t slot = PageTableProbe(table, page_id, empty_slot);
+  return slot == -1 ? -1 : table->slots_[slot].frame_id_;
+}
+
+// Return the frame of a page, -1 if it isn't in the table, while another thread may be changing the table. Every byte
+// and slot is read atomically, one at a time, so the result is only meaningful if the table didn't change meanwhile.
+// The probe gives up after a full lap, a racing writer may hide every empty byte from it.
+static inline frame_id_t PageTableFindConcurrent(const PageTable *table, page_id_t page_id) {
+  const uint64_t hash = PageTableHash(page_id);
+  const uint8_t byte = PageTableControlByte(hash);
+  size_t slot = PageTableHomeSlot(table, hash);
+  for (size_t step = 0; step <= table->mask_; ++step) {
+    const uint8_t ctrl = PAGE_TABLE_LOAD(table->ctrl_[slot]);
+    if (ctrl == PAGE_TABLE_EMPTY) {
+      return -1;
+    }
+    if (ctrl == byte && PAGE_TABLE_LOAD(table->slots_[slot].page_id_) == page_id) {
+      return PAGE_TABLE_LOAD(table->slots_[slot].frame_id_);
+    }
+    slot = (slot + 1) & table->mask_;
+  }
+  return -1;
+}
+
+// Prefetch the control bytes and the slots where the probe for a page starts
+static inline void PageTablePrefetch(const PageTable *table, page_id_t page_id) {
+#if defined __GNUC__ || defined __clang__
+  const size_t pos = PageTableHomeSlot(table, PageTableHash(page_id));
+  __builtin_prefetch(table->ctrl_ + pos);
+  __builtin_prefetch(table->slots_ + pos);
+#else
+  (void)table;
+  (void)page_id;
+#endif
+}
+#endif
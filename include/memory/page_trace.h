@@ -0,0 +1,58 @@
+#ifndef PAGE_TRACE_H
+#define PAGE_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "replacer.h"
+
+//===----------------------------------------------------------------------===//
+// Page Trace statement
+//===----------------------------------------------------------------------===//
+// A page trace file starts with a 24-byte little-endian header: the magic "PGTRACE\0", a 32-bit version, 32 reserved
+// bits and the 64-bit number of accesses. The body stores every access as the difference to the previous page id
+// (0 before the first access), zigzag encoded into a LEB128 varint, so a local access takes a single byte.
+#define PAGE_TRACE_HEADER_SIZE 24
+#define PAGE_TRACE_VERSION 1
+
+typedef struct PageTraceWriter {
+  FILE *file_;
+  size_t access_num_;
+  page_id_t last_page_;
+} PageTraceWriter;
+
+// Create a trace file, NULL if it can't be created
+PageTraceWriter *PageTraceWriterOpen(const char *path);
+
+// Append one access to the trace
+bool PageTraceWriterAppend(PageTraceWriter *writer, page_id_t page_id);
+
+// Write the final header and close the file, false if any write failed
+bool PageTraceWriterClose(PageTraceWriter *writer);
+
+// The reader maps the file instead of loading it, so traces larger than memory stream from the page cache
+typedef struct PageTraceReader {
+  const uint8_t *data_;  // The mapped file
+  size_t file_size_;
+  size_t access_num_;  // Number of accesses announced by the header
+  size_t read_num_;    // Number of accesses decoded since the last rewind
+  size_t offset_;      // Offset of the next varint
+  page_id_t last_page_;
+} PageTraceReader;
+
+// Map a trace file, NULL if it can't be opened, isn't a page trace or holds fewer accesses than its header announces
+PageTraceReader *PageTraceReaderOpen(const char *path);
+
+// Unmap the trace file
+void PageTraceReaderClose(PageTraceReader *reader);
+
+// Decode up to n accesses into page_ids, return how many were decoded, 0 at the end of the trace
+size_t PageTraceReaderRead(PageTraceReader *reader, page_id_t *page_ids, size_t n);
+
+// Restart from the first access, so several policies can replay the same trace
+void PageTraceReaderRewind(PageTraceReader *reader);
+
+// Return the number of accesses in the trace
+size_t PageTraceReaderSize(const PageTraceReader *reader);
+#endif
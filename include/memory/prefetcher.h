@@ -0,0 +1,52 @@
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "replacer.h"
+
+//===----------------------------------------------------------------------===//
+// Prefetcher statement
+//===----------------------------------------------------------------------===//
+// Read-ahead for sequential and strided page streams. Every requester may run several streams at once, an access
+// continues the stream of that requester whose last page is within PREFETCH_STREAM_WINDOW pages, or starts a new one
+// in place of the least recently used stream. Once PREFETCH_CONFIDENCE accesses in a row moved by the same stride, the
+// stream asks for the next degree pages along the stride and then keeps degree pages ahead of its accesses.
+#define PREFETCH_STREAM_WINDOW 64
+#define PREFETCH_CONFIDENCE 2
+
+typedef struct PrefetchStream {
+  uint32_t requester_;
+  page_id_t last_page_;
+  int64_t stride_;
+  int64_t prefetched_to_;  // The last page asked for along the stride
+  uint32_t confidence_;    // Accesses in a row that moved by stride_
+  uint64_t last_use_;
+  bool valid_;
+} PrefetchStream;
+
+typedef struct Prefetcher {
+  PrefetchStream *streams_;
+  size_t stream_num_;
+  size_t degree_;
+  uint64_t clock_;
+} Prefetcher;
+
+// What a buffer manager did with the pages its prefetcher asked for
+typedef struct PrefetchStats {
+  size_t issued_num_;          // Pages brought in by a prefetch
+  size_t hit_num_;             // Prefetched pages that were accessed before their eviction
+  size_t wasted_num_;          // Prefetched pages evicted without an access
+  size_t pollution_miss_num_;  // Misses on a page that was evicted to make room for a prefetch
+} PrefetchStats;
+
+// Initialize a prefetcher tracking up to stream_num streams that reads degree pages ahead
+Prefetcher *PrefetcherInit(size_t stream_num, size_t degree);
+
+void PrefetcherDestroy(Prefetcher *prefetcher);
+
+// Record an access of a requester and write the pages to prefetch into prefetch_pages, which holds degree pages.
+// Returns how many pages were written.
+size_t PrefetcherObserve(Prefetcher *prefetcher, uint32_t requester, page_id_t page_id, page_id_t *prefetch_pages);
+#endif
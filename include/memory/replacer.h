@@ -1,32 +1,34 @@
 #ifndef REPLACER_H
 #define REPLACER_H
 
-#define i_type UIList
-#define i_key size_t
-// Include type size_t
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
-#include "stc/clist.h"
 
 typedef int32_t frame_id_t;
+typedef int32_t page_id_t;
 
 typedef struct Frame {
-  UIList history_;
+  size_t *history_;          // Circular buffer holding the last k access timestamps
+  size_t next_slot_;         // Slot of history_ to be overwritten by the next access
+  size_t access_num_;        // The number of accesses since the frame was inserted
+  size_t oldest_timestamp_;  // The first access since the frame was inserted
   size_t k_;
   frame_id_t fid_;
+  frame_id_t prev_;  // Previous frame in the FIFO replacer's queue, -1 if none
+  frame_id_t next_;  // Next frame in the FIFO replacer's queue, -1 if none
+  bool is_present_;  // Whether the frame is tracked by its replacer
   bool is_evictable_;
 } Frame;
 
 //===----------------------------------------------------------------------===//
 // Frame statement
 //===----------------------------------------------------------------------===//
-Frame FrameInit(size_t k, frame_id_t fid);
+// The frame records its last k accesses into history, which must have room for k timestamps
+Frame FrameInit(size_t k, frame_id_t fid, size_t *history);
 
-Frame Frame_clone(Frame node);
-
-// Destructor for Frame
-void FrameDestroy(Frame *node);
+// Forget the access history of a frame, e.g. when it is evicted
+void FrameReset(Frame *node);
 
 // Check whether a frame is evictable
 bool IsEvictable(Frame *node);
@@ -50,15 +52,38 @@ size_t KthTimestamp(Frame *node);
 //===----------------------------------------------------------------------===//
 // Replacer statement
 //===----------------------------------------------------------------------===//
-#define i_type FrameTable
-#define i_key frame_id_t
-#define i_valclass Frame
-#define i_valclone Frame_clone
-#define i_valdrop FrameDestroy
-#include "stc/cmap.h"
+// Position of an evictable frame in the eviction index. Frames with less than k accesses have
+// +inf backward k-distance and sort before the others, so the front of the index is the victim.
+typedef struct EvictKey {
+  bool has_k_history_;  // Whether the frame has been accessed at least k times
+  size_t kth_timestamp_;
+  size_t oldest_timestamp_;
+  frame_id_t fid_;
+} EvictKey;
+
+static inline int EvictKey_cmp(const EvictKey *lhs, const EvictKey *rhs) {
+  if (lhs->has_k_history_ != rhs->has_k_history_) {
+    return lhs->has_k_history_ ? 1 : -1;
+  }
+  // Smaller k-th timestamp means larger backward k-distance
+  if (lhs->kth_timestamp_ != rhs->kth_timestamp_) {
+    return lhs->kth_timestamp_ < rhs->kth_timestamp_ ? -1 : 1;
+  }
+  if (lhs->oldest_timestamp_ != rhs->oldest_timestamp_) {
+    return lhs->oldest_timestamp_ < rhs->oldest_timestamp_ ? -1 : 1;
+  }
+  return (lhs->fid_ > rhs->fid_) - (lhs->fid_ < rhs->fid_);
+}
+
+#define i_type EvictIndex
+#define i_key EvictKey
+#define i_cmp EvictKey_cmp
+#include "stc/csset.h"
 
 typedef struct LRUKReplacer {
-  FrameTable node_store_;
+  Frame *node_store_;       // Frames indexed by frame id
+  size_t *history_store_;   // The k-slot histories of all frames in one allocation
+  EvictIndex evict_index_;  // Evictable frames ordered by eviction priority
   size_t current_timestamp_;
   size_t curr_size_;      // The number of evictable frames
   size_t replacer_size_;  // Maximum number of frames in the replacer
@@ -87,13 +112,24 @@ void ReplacerRecordAccess(Replacer *replacer, frame_id_t frame_id);
 // Toggle whether a frame is evictable or non-evictable
 void ReplacerSetEvictable(Replacer *replacer, frame_id_t frame_id, bool set_evictable);
 
+// Record the access that faulted a page into a frame, LRU-K keeps no history of evicted pages so the page is ignored
+void ReplacerAdmit(Replacer *replacer, frame_id_t frame_id, page_id_t page_id);
+
+// Record a hit on every frame in order, the same as RecordAccess followed by SetEvictable(true) on each of them
+void ReplacerRecordHits(Replacer *replacer, const frame_id_t *frame_ids, size_t n);
+
 // Return replacer's size, which tracks the number of evictable frames
 size_t ReplacerSize(Replacer *replacer);
+
+// Return the bytes of memory the replacer holds, the replacer itself included
+size_t ReplacerMemoryUsage(Replacer *replacer);
 //===----------------------------------------------------------------------===//
 // FIFO Replacer statement
 //===----------------------------------------------------------------------===//
 typedef struct FIFOReplacer {
-  FrameTable node_store_;
+  Frame *node_store_;  // Frames indexed by frame id
+  frame_id_t head_;    // The frame with the earliest first access, evictable or not, -1 if none
+  frame_id_t tail_;    // The frame with the latest first access, -1 if none
   size_t current_timestamp_;
   size_t curr_size_;      // The number of evictable frames
   size_t replacer_size_;  // Maximum number of frames in the replacer
@@ -114,6 +150,75 @@ void FIFOReplacerRecordAccess(FIFOReplacer *replacer, frame_id_t frame_id);
 // Toggle whether a frame is evictable or non-evictable
 void FIFOReplacerSetEvictable(FIFOReplacer *replacer, frame_id_t frame_id, bool set_evictable);
 
+// Record the access that faulted a page into a frame, FIFO doesn't depend on page identity so the page is ignored
+void FIFOReplacerAdmit(FIFOReplacer *replacer, frame_id_t frame_id, page_id_t page_id);
+
+// Record a hit on every frame in order, the same as RecordAccess followed by SetEvictable(true) on each of them
+void FIFOReplacerRecordHits(FIFOReplacer *replacer, const frame_id_t *frame_ids, size_t n);
+
 // Return replacer's size, which tracks the number of evictable frames
 size_t FIFOReplacerSize(FIFOReplacer *replacer);
+
+// Return the bytes of memory the replacer holds, the replacer itself included
+size_t FIFOReplacerMemoryUsage(FIFOReplacer *replacer);
+//===----------------------------------------------------------------------===//
+// Replacer interface statement
+//===----------------------------------------------------------------------===//
+// Operations every replacer provides, so a buffer manager can pick its policy at runtime.
+// When a page is faulted into a frame, the buffer manager records that access with admit instead of record_access.
+typedef struct ReplacerVTable {
+  bool (*evict)(void *replacer, frame_id_t *frame_id);
+  void (*record_access)(void *replacer, frame_id_t frame_id);
+  void (*record_hits)(void *replacer, const frame_id_t *frame_ids, size_t n);
+  void (*set_evictable)(void *replacer, frame_id_t frame_id, bool set_evictable);
+  void (*admit)(void *replacer, frame_id_t frame_id, page_id_t page_id);
+  size_t (*size)(void *replacer);
+  size_t (*memory_usage)(void *replacer);
+  void (*destroy)(void *replacer);
+} ReplacerVTable;
+
+// A replacer of any policy, passed around by value
+typedef struct AnyReplacer {
+  void *self;
+  const ReplacerVTable *vtable;
+} AnyReplacer;
+
+extern const ReplacerVTable LRUKReplacerVTable;
+extern const ReplacerVTable FIFOReplacerVTable;
+
+static inline AnyReplacer ReplacerAsAny(Replacer *replacer) {
+  return (AnyReplacer){.self = replacer, .vtable = &LRUKReplacerVTable};
+}
+
+static inline AnyReplacer FIFOReplacerAsAny(FIFOReplacer *replacer) {
+  return (AnyReplacer){.self = replacer, .vtable = &FIFOReplacerVTable};
+}
+
+static inline void AnyReplacerDestroy(AnyReplacer replacer) { replacer.vtable->destroy(replacer.self); }
+
+static inline bool AnyReplacerEvict(AnyReplacer replacer, frame_id_t *frame_id) {
+  return replacer.vtable->evict(replacer.self, frame_id);
+}
+
+static inline void AnyReplacerRecordAccess(AnyReplacer replacer, frame_id_t frame_id) {
+  replacer.vtable->record_access(replacer.self, frame_id);
+}
+
+static inline void AnyReplacerRecordHits(AnyReplacer replacer, const frame_id_t *frame_ids, size_t n) {
+  replacer.vtable->record_hits(replacer.self, frame_ids, n);
+}
+
+static inline void AnyReplacerSetEvictable(AnyReplacer replacer, frame_id_t frame_id, bool set_evictable) {
+  replacer.vtable->set_evictable(replacer.self, frame_id, set_evictable);
+}
+
+static inline void AnyReplacerAdmit(AnyReplacer replacer, frame_id_t frame_id, page_id_t page_id) {
+  replacer.vtable->admit(replacer.self, frame_id, page_id);
+}
+
+static inline size_t AnyReplacerSize(AnyReplacer replacer) { return replacer.vtable->size(replacer.self); }
+
+static inline size_t AnyReplacerMemoryUsage(AnyReplacer replacer) {
+  return replacer.vtable->memory_usage(replacer.self);
+}
 #endif
@@ -0,0 +1,95 @@
+#ifndef SHARDED_BUFFER_MANAGER_H
+#define SHARDED_BUFFER_MANAGER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "buffer_manager.h"
+#include "replacer.h"
+
+//===----------------------------------------------------------------------===//
+// ShardedBufferManager statement
+//===----------------------------------------------------------------------===//
+// Buffer manager that can be called from many threads. Pages are partitioned into shards by hash, and every shard
+// is a BufferManager with its own page table, free frames and replacer behind its own lock, so threads only contend
+// when they touch the same shard. A page always maps to the same shard, so a shard behaves exactly like a
+// BufferManager of its size that sees the accesses to its pages in the order it locked them.
+//
+// FetchPageBuffered is the read-mostly mode in the spirit of BP-Wrapper. A hit looks the page table up without the
+// lock, validated by the shard's sequence number, and is only queued in the calling thread's hit buffer. The queue is
+// handed to the replacer in one batch once it fills up, so hits don't contend on the lock or the replacer's state.
+// Misses still take the lock. The replacer learns about queued hits late, so with buffered hits a shard no longer
+// matches a sequential BufferManager access for access.
+typedef struct ShardedBufferManagerShard {
+  _Alignas(64) pthread_mutex_t lock_;  // Every shard starts on its own cache line to avoid false sharing
+  atomic_uint sequence_;               // Odd while the page table is being changed under the lock
+  BufferManager *manager_;
+  frame_id_t frame_base_;  // The shard's frames are frame_base_ up to frame_base_ + pool_size_ - 1
+  size_t pool_size_;
+  size_t access_num_;  // Successful fetches, hits are the ones that didn't miss
+} ShardedBufferManagerShard;
+
+typedef struct ShardedBufferManager {
+  ShardedBufferManagerShard *shards_;
+  size_t shard_num_;
+  size_t pool_size;
+} ShardedBufferManager;
+
+// Initialize the buffer manager with shard_num shards sharing pool_size frames, every shard gets its own replacer
+// from create_replacer
+ShardedBufferManager *ShardedBufferManagerInit(size_t pool_size, size_t shard_num,
+                                               AnyReplacer (*create_replacer)(size_t frames_num));
+
+// Destroy the buffer manager and the replacers of its shards
+void ShardedBufferManagerDestroy(ShardedBufferManager *manager);
+
+// Access a page from any thread like BufferManagerAccessPage, the frame id is unique across shards
+frame_id_t ShardedBufferManagerFetchPage(ShardedBufferManager *manager, page_id_t page_id);
+
+// Hits a thread hasn't handed to the replacer yet, per shard
+#define SHARDED_HIT_BUFFER_SIZE 64
+
+typedef struct ShardedBufferManagerPendingHits {
+  frame_id_t frame_ids_[SHARDED_HIT_BUFFER_SIZE];  // Frame ids inside the shard
+  page_id_t page_ids_[SHARDED_HIT_BUFFER_SIZE];    // The page each frame held, to drop hits on frames evicted since
+  size_t size_;
+} ShardedBufferManagerPendingHits;
+
+// A thread's queue of hits for every shard, it must only be used by one thread at a time
+typedef struct ShardedBufferManagerHitBuffer {
+  ShardedBufferManager *manager_;
+  ShardedBufferManagerPendingHits *pending_;
+} ShardedBufferManagerHitBuffer;
+
+// Create a hit buffer for the calling thread
+ShardedBufferManagerHitBuffer *ShardedBufferManagerHitBufferInit(ShardedBufferManager *manager);
+
+// Hand the queued hits to the replacers and destroy the buffer, before the manager is destroyed
+void ShardedBufferManagerHitBufferDestroy(ShardedBufferManagerHitBuffer *buffer);
+
+// Hand every queued hit to the replacers
+void ShardedBufferManagerHitBufferFlush(ShardedBufferManagerHitBuffer *buffer);
+
+// Fetch a page like FetchPage, but look hits up without the lock and queue them in the buffer
+frame_id_t ShardedBufferManagerFetchPageBuffered(ShardedBufferManagerHitBuffer *buffer, page_id_t page_id);
+
+// Sum the misses of every shard, only exact when no other thread is fetching and every hit buffer is flushed
+void ShardedBufferManagerGetMissNum(ShardedBufferManager *manager, size_t *compulsory_miss_num,
+                                    size_t *capacity_miss_num);
+
+// Sum the hits of every shard, only exact when no other thread is fetching and every hit buffer is flushed
+size_t ShardedBufferManagerGetHitNum(ShardedBufferManager *manager);
+
+// Return the shard of a page. The page is mixed with a hash other than the page table's, so the pages of a shard
+// still spread over its whole page table.
+static inline size_t ShardedBufferManagerShardOf(const ShardedBufferManager *manager, page_id_t page_id) {
+  uint32_t hash = (uint32_t)page_id;
+  hash ^= hash >> 16;
+  hash *= UINT32_C(0x85ebca6b);
+  hash ^= hash >> 13;
+  hash *= UINT32_C(0xc2b2ae35);
+  hash ^= hash >> 16;
+  return (size_t)(((uint64_t)hash * manager->shard_num_) >> 32);
+}
+#endif
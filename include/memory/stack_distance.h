@@ -0,0 +1,42 @@
+#ifndef STACK_DISTANCE_H
+#define STACK_DISTANCE_H
+
+#include <stddef.h>
+#include "replacer.h"
+
+#define i_type LastAccessTable
+#define i_key page_id_t
+#define i_val size_t
+#include "stc/cmap.h"
+
+//===----------------------------------------------------------------------===//
+// Stack Distance Analyzer statement
+//===----------------------------------------------------------------------===//
+// Mattson's stack algorithm. LRU has the inclusion property, so an access hits with c frames iff its stack
+// distance, the number of distinct pages touched since the last access to the same page, is less than c. One pass
+// over a trace yields the miss count of every pool size. Distinct pages are counted with a Fenwick tree over access
+// timestamps, where only the latest access of every page is marked.
+typedef struct StackDistanceAnalyzer {
+  size_t *tree_;                // Fenwick tree over timestamps, 1-based
+  size_t tree_size_;            // Number of timestamps the tree can hold before it is compacted
+  LastAccessTable last_access_; // Latest timestamp of every page
+  size_t *distance_num_;        // distance_num_[d] is the number of accesses with stack distance d
+  size_t max_pool_size_;        // Distances from max_pool_size_ on are misses for every tracked pool size
+  size_t far_access_num_;       // Accesses with a stack distance of at least max_pool_size_
+  size_t cold_miss_num_;        // First accesses, which miss for every pool size
+  size_t access_num_;
+  size_t current_timestamp_;
+} StackDistanceAnalyzer;
+
+// Initialize the analyzer for pool sizes up to max_pool_size
+StackDistanceAnalyzer *StackDistanceAnalyzerInit(size_t max_pool_size);
+
+// Destroy the analyzer to avoid memory leak
+void StackDistanceAnalyzerDestroy(StackDistanceAnalyzer *analyzer);
+
+// Account one access of the trace in O(log n)
+void StackDistanceAnalyzerAccess(StackDistanceAnalyzer *analyzer, page_id_t page_id);
+
+// Fill miss_num[c - 1] with the number of LRU misses on c frames, for c from 1 to max_pool_size
+void StackDistanceAnalyzerMissCurve(const StackDistanceAnalyzer *analyzer, size_t *miss_num);
+#endif
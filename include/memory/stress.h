@@ -0,0 +1,27 @@
+#ifndef STRESS_H
+#define STRESS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "replacer.h"
+#include "sharded_buffer_manager.h"
+
+//===----------------------------------------------------------------------===//
+// Stress statement
+//===----------------------------------------------------------------------===//
+// Drives a ShardedBufferManager from many threads at once and collects what it counted, so the caller can check
+// that hits and misses add up to the accesses the threads made.
+typedef struct StressResult {
+  size_t access_num_;  // Accesses made by all threads
+  size_t hit_num_;
+  size_t compulsory_miss_num_;
+  size_t capacity_miss_num_;
+  size_t bad_frame_num_;  // Fetches that failed or returned a frame outside the pool
+  double seconds_;        // Wall time from the start of the first thread to the end of the last one
+} StressResult;
+
+// Fetch pages[t][0] to pages[t][access_num - 1] on thread t for every t below thread_num, false if a thread can't be
+// started. With buffered_hits every thread fetches through its own hit buffer.
+bool StressRun(ShardedBufferManager *manager, page_id_t *const *pages, size_t access_num, size_t thread_num,
+               bool buffered_hits, StressResult *result);
+#endif
@@ -0,0 +1,39 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "replacer.h"
+#include "stc/crand.h"
+
+//===----------------------------------------------------------------------===//
+// Sweep statement
+//===----------------------------------------------------------------------===//
+// Replays many (policy, pool size, seed) configurations on a pool of threads. Every configuration is seeded on its
+// own and writes only its own result, so the results don't depend on the number of threads or on scheduling.
+
+// A replacement policy of the sweep
+typedef struct SweepPolicy {
+  const char *name_;
+  AnyReplacer (*create_replacer_)(size_t frames_num);  // NULL for OPT, which is simulated without a buffer manager
+} SweepPolicy;
+
+typedef struct SweepConfig {
+  const SweepPolicy *policy_;
+  size_t frames_num_;
+  uint64_t seed_;
+  size_t miss_num_;    // Filled in by the sweep
+  size_t access_num_;  // Filled in by the sweep
+} SweepConfig;
+
+// The reference strings of the sweep, one trace file shared read-only by every worker or one generated per seed
+typedef struct SweepWorkload {
+  const char *trace_path_;                                  // NULL to generate the reference strings
+  void (*generate_trace_)(crand_t *rng, page_id_t *pages);  // Generate a reference string of generated_access_num_
+  size_t generated_access_num_;
+} SweepWorkload;
+
+// Run every configuration on thread_num threads, false if the trace file can't be replayed
+bool SweepRun(SweepConfig *configs, size_t config_num, const SweepWorkload *workload, size_t thread_num);
+#endif
@@ -0,0 +1,64 @@
+#ifndef TWO_QUEUE_REPLACER_H
+#define TWO_QUEUE_REPLACER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ghost_pool.h"
+#include "index_list.h"
+#include "replacer.h"
+
+//===----------------------------------------------------------------------===//
+// 2Q Replacer statement
+//===----------------------------------------------------------------------===//
+// Full 2Q (Johnson and Shasha, VLDB 1994). New pages enter the FIFO A1in, pages evicted from A1in are remembered
+// on the ghost FIFO A1out, and only a page faulted again while on A1out is admitted to the LRU list Am.
+typedef struct TwoQueueReplacer {
+  IndexLink *frame_links_;  // Links of every frame on A1in or Am
+  uint8_t *frame_state_;    // List and evictable bit of every frame, indexed by frame id
+  page_id_t *frame_pages_;  // Page resident in every frame, -1 if the page wasn't admitted
+  IndexList a1in_;          // Resident pages seen once, in FIFO order
+  IndexList am_;            // Resident hot pages, in LRU order
+  IndexList a1out_;         // Pages evicted from A1in, in FIFO order
+  GhostPool ghosts_;        // Pages on A1out
+  size_t kin_;              // Target size of A1in
+  size_t kout_;             // Maximum size of A1out
+  size_t curr_size_;        // The number of evictable frames
+  size_t replacer_size_;    // Maximum number of frames in the replacer
+} TwoQueueReplacer;
+
+// Initialize the replacer with the sizes recommended by the paper, A1in = 25% and A1out = 50% of the frames
+TwoQueueReplacer *TwoQueueReplacerInit(size_t num_frames);
+
+// Destroy the replacer to avoid memory leak
+void TwoQueueReplacerDestroy(TwoQueueReplacer *replacer);
+
+// Evict the oldest evictable frame of A1in if A1in exceeds its target, otherwise the least recently used of Am
+bool TwoQueueReplacerEvict(TwoQueueReplacer *replacer, frame_id_t *frame_id);
+
+// Record the access of a frame, which only reorders Am
+void TwoQueueReplacerRecordAccess(TwoQueueReplacer *replacer, frame_id_t frame_id);
+
+// Toggle whether a frame is evictable or non-evictable
+void TwoQueueReplacerSetEvictable(TwoQueueReplacer *replacer, frame_id_t frame_id, bool set_evictable);
+
+// Record the access that faulted a page into a frame, the page goes to Am if it is on A1out and to A1in otherwise
+void TwoQueueReplacerAdmit(TwoQueueReplacer *replacer, frame_id_t frame_id, page_id_t page_id);
+
+// Record a hit on every frame in order, the same as RecordAccess followed by SetEvictable(true) on each of them
+void TwoQueueReplacerRecordHits(TwoQueueReplacer *replacer, const frame_id_t *frame_ids, size_t n);
+
+// Return replacer's size, which tracks the number of evictable frames
+size_t TwoQueueReplacerSize(TwoQueueReplacer *replacer);
+
+// Return the bytes of memory the replacer holds, the replacer itself included
+size_t TwoQueueReplacerMemoryUsage(TwoQueueReplacer *replacer);
+//===----------------------------------------------------------------------===//
+// Replacer interface statement
+//===----------------------------------------------------------------------===//
+extern const ReplacerVTable TwoQueueReplacerVTable;
+
+static inline AnyReplacer TwoQueueReplacerAsAny(TwoQueueReplacer *replacer) {
+  return (AnyReplacer){.self = replacer, .vtable = &TwoQueueReplacerVTable};
+}
+#endif
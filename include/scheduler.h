@@ -1,14 +1,33 @@
 #ifndef SCHDULER_H
 #define SCHDULER_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #define MAXNUM 10
+#define MLFQ_MAX_QUEUES 64
+
+struct EventLog;
+struct JobSource;
 
-typedef enum Policy { FIFO, SJF, RR, MLFQ } Policy;
+typedef enum Policy { FIFO, SJF, STCF, RR, MLFQ } Policy;
 typedef struct Job {
-  unsigned int pid;      // Simulate the process id in the system
-  unsigned int runtime;  // Total runtime of the process
+  unsigned int pid;        // Simulate the process id in the system
+  unsigned int runtime;    // Total runtime of the process
+  unsigned int remaining;  // Runtime the process still needs
+  unsigned int priority;   // The queue of the process in MLFQ
+  uint32_t epoch;          // The MLFQ boosts there were when the process last ran
+  int64_t arrival;         // Time the process arrives at
+  int64_t first_run;       // Time the process first ran, -1 until then
+  struct Job *next;        // The next process in the same MLFQ queue
 } Job;
 
+// How a run reports what it does
+typedef struct RunOptions {
+  bool quiet;            // Print only the summary statistics, not every burst and process
+  struct EventLog *log;  // Record every burst into it if not NULL
+} RunOptions;
+
 #define i_type JobDeque
 #define i_key struct Job *
 #define i_less(a, b) a->runtime < b->runtime
@@ -20,12 +39,18 @@ void print_joblist(Job *p, int jobnum);
 
 enum Policy get_policy(const char *policy);
 
-void fifo_statistics(Job *joblist, int jobnum);
+void fifo_statistics(Job *joblist, int jobnum, const RunOptions *options);
 
 void sjf_sort(Job *joblist, int jobnum);
 
-void rr_statistics(Job *joblist, int jobnum, int time_slice);
+void stcf_statistics(Job *joblist, int jobnum, const RunOptions *options);
+
+void rr_statistics(Job *joblist, int jobnum, int time_slice, const RunOptions *options);
+
+void mlfq_statistics(Job *joblist, int jobnum, int numQueues, int time_slice, int boost, const RunOptions *options);
 
-void mlfq_statistics(Job *joblist, int jobnum, int numQueues, int time_slice, int boost);
+// Run the jobs of a source as they arrive and print the summary of the run instead of every job
+void open_statistics(const struct JobSource *source, Policy policy, int time_slice, int numQueues, int boost,
+                     const RunOptions *options);
 
 #endif
@@ -0,0 +1,43 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "scheduler/sim_engine.h"
+
+//===----------------------------------------------------------------------===//
+// Event Log statement
+//===----------------------------------------------------------------------===//
+// Records every burst of a simulation. The records are formatted into a large buffer that goes to the file in one
+// write once it is full, so logging millions of bursts costs a few writes rather than a stdio call per burst.
+//
+// The CSV format has a "time,pid,length,end" header line and a line per burst, end is finished, expired, yielded or
+// preempted. The binary format starts with a 24-byte little-endian header: the magic "SCHDLOG\0", a 32-bit version,
+// 32 reserved bits and the 64-bit number of bursts. Every burst follows as a 24-byte little-endian record: the 64-bit
+// start and length, the 32-bit pid and the 32-bit BurstEnd.
+#define EVENT_LOG_BUFFER_SIZE (1 << 20)
+#define EVENT_LOG_HEADER_SIZE 24
+#define EVENT_LOG_RECORD_SIZE 24
+#define EVENT_LOG_VERSION 1
+
+typedef enum EventLogFormat { EVENT_LOG_CSV, EVENT_LOG_BINARY } EventLogFormat;
+
+typedef struct EventLog {
+  FILE *file_;
+  EventLogFormat format_;
+  char *buffer_;
+  size_t size_;  // Bytes in the buffer
+  uint64_t record_num_;
+  bool failed_;  // A write failed, the log is incomplete
+} EventLog;
+
+// Create a log file, NULL if it can't be created
+EventLog *event_log_open(const char *path, EventLogFormat format);
+
+void event_log_write(EventLog *log, const Burst *burst);
+
+// Flush the buffer, write the final header and close the file, false if any write failed
+bool event_log_close(EventLog *log);
+#endif
@@ -0,0 +1,135 @@
+#ifndef SIM_ENGINE_H
+#define SIM_ENGINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "scheduler.h"
+
+struct EventLog;
+
+//===----------------------------------------------------------------------===//
+// Simulation Engine statement
+//===----------------------------------------------------------------------===//
+// Discrete-event simulation of one CPU. Arrivals, the ends of CPU bursts and I/O completions are events in a binary
+// heap keyed by time, the engine jumps from one event to the next, so a run costs O(events log events) however long
+// the jobs are and an idle CPU costs nothing. A policy only decides which ready job runs next and for how long.
+//
+// A job that can't finish within its slice yields for I/O halfway through the slice with a 1 in yield_chance chance,
+// otherwise its slice expires. A job that yielded is ready again io_time later. A preemptive policy may also take the
+// CPU away from the running job whenever other jobs became ready.
+//
+// The jobs come either from a list added up front, or from a job source that is asked for the next job only when the
+// previous one arrived. The simulator recycles the jobs of a source once they finished, so an open system of any
+// length runs in memory bounded by the jobs in it at once.
+
+// Why a job became ready
+typedef enum ReadyReason {
+  READY_ARRIVED,    // The job just arrived
+  READY_EXPIRED,    // The job ran for its whole slice
+  READY_YIELDED,    // The job yielded and its I/O is done
+  READY_PREEMPTED,  // The policy took the CPU away from the job
+} ReadyReason;
+
+// How a burst ended
+typedef enum BurstEnd { BURST_FINISHED, BURST_EXPIRED, BURST_YIELDED, BURST_PREEMPTED } BurstEnd;
+
+typedef struct Burst {
+  Job *job;
+  int64_t start;
+  int64_t length;
+  BurstEnd end;
+} Burst;
+
+// The callbacks of a scheduling policy, each one gets the state of the policy first
+typedef struct SchedulerOps {
+  // A job became ready to run
+  void (*ready)(void *policy, Job *job, ReadyReason reason, int64_t now);
+  // Pick the job to run next and store the longest it may run into slice, 0 to run it to completion. NULL if no job
+  // is ready.
+  Job *(*dispatch)(void *policy, int64_t now, int64_t *slice);
+  // A burst ended, called before the job is ready again. May be NULL.
+  void (*burst_done)(void *policy, const Burst *burst);
+  // Whether to take the CPU away from the running job, which still needs remaining, once the jobs that became ready
+  // at this time are in. May be NULL for a policy that never preempts.
+  bool (*preempt)(void *policy, const Job *running, int64_t remaining);
+} SchedulerOps;
+
+// Streams jobs into a simulator in the order they arrive
+typedef struct JobSource {
+  // Write the pid, runtime and arrival of the next job into job, false if there are no more jobs
+  bool (*next)(void *state, Job *job);
+  void *state;
+} JobSource;
+
+#define i_type JobStack
+#define i_key Job *
+#include "stc/cvec.h"
+
+typedef enum SimEventKind { SIM_ARRIVAL, SIM_BURST_END, SIM_IO_DONE } SimEventKind;
+
+typedef struct SimEvent {
+  int64_t time;
+  uint64_t sequence;  // Events at the same time are handled in the order they were scheduled
+  SimEventKind kind;
+  Job *job;
+} SimEvent;
+
+// Reversed, so the earliest event is on top of the max-heap
+static inline int SimEvent_cmp(const SimEvent *lhs, const SimEvent *rhs) {
+  if (lhs->time != rhs->time) {
+    return lhs->time > rhs->time ? -1 : 1;
+  }
+  return (lhs->sequence < rhs->sequence) - (lhs->sequence > rhs->sequence);
+}
+
+#define i_type SimEventHeap
+#define i_key SimEvent
+#define i_cmp SimEvent_cmp
+#include "stc/cpque.h"
+
+typedef struct Simulator {
+  SimEventHeap events_;
+  uint64_t sequence_;
+  int64_t now_;
+  Burst burst_;           // The burst on the CPU, its job is NULL while the CPU is idle
+  uint64_t burst_event_;  // The end event of the burst, a preempted burst leaves an end event behind to skip
+  int yield_chance_;
+  int64_t io_time_;
+  struct EventLog *log_;  // Records every burst if not NULL
+  JobSource source_;      // No source if its next is NULL
+  JobStack jobs_;         // Every job allocated for the source
+  JobStack free_jobs_;    // Jobs of the source that finished, to reuse for the next arrivals
+  size_t job_num_;        // Jobs with pids below it are recorded by pid
+  size_t finished_num_;
+  int64_t busy_time_;  // Time the CPU spent running jobs
+  int64_t response_sum_;
+  int64_t turnaround_sum_;
+  int64_t max_turnaround_;
+  int64_t *responses_;    // Time from the arrival to the first burst of each job by pid
+  int64_t *turnarounds_;  // Time from the arrival to the completion of each job by pid
+} Simulator;
+
+// Initialize a simulator that records the jobs with pids below job_num one by one. yield_chance 0 never yields.
+Simulator *sim_init(size_t job_num, int yield_chance, int64_t io_time);
+
+void sim_destroy(Simulator *sim);
+
+// Schedule the arrival of a job at job->arrival, it runs for job->runtime. The job must outlive the run.
+void sim_add_job(Simulator *sim, Job *job);
+
+// Take the jobs from a source instead of a list
+void sim_set_source(Simulator *sim, JobSource source);
+
+// Record every burst into a log, NULL to stop
+void sim_set_log(Simulator *sim, struct EventLog *log);
+
+// Run the jobs under a policy until the last event
+void sim_run(Simulator *sim, void *policy, const SchedulerOps *ops);
+
+// Print the response and turnaround of the jobs of the list and their averages
+void sim_print_statistics(const Simulator *sim, const Job *joblist, int jobnum);
+
+// Print the averages over every job that finished and the utilization of the CPU
+void sim_print_summary(const Simulator *sim);
+#endif
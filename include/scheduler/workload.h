@@ -0,0 +1,68 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "scheduler.h"
+#include "stc/crand.h"
+
+//===----------------------------------------------------------------------===//
+// Distribution statement
+//===----------------------------------------------------------------------===//
+// A distribution is written as its name followed by its parameters, separated by colons:
+//   const:VALUE
+//   uniform:LOW:HIGH
+//   exp:MEAN                 Exponential, the inter-arrival times of a Poisson process
+//   pareto:ALPHA:MIN         Heavy-tailed, the smaller ALPHA the heavier the tail. Infinite mean for ALPHA <= 1.
+//   bimodal:SHORT:LONG:P     LONG with probability P, SHORT otherwise
+typedef enum DistributionKind {
+  DIST_CONSTANT,
+  DIST_UNIFORM,
+  DIST_EXPONENTIAL,
+  DIST_PARETO,
+  DIST_BIMODAL,
+} DistributionKind;
+
+typedef struct Distribution {
+  DistributionKind kind;
+  double param[3];  // The parameters in the order they are written
+} Distribution;
+
+// Parse a distribution, false if the spec is invalid
+bool parse_distribution(const char *spec, Distribution *dist);
+
+double sample_distribution(const Distribution *dist, crand_t *rng);
+
+double distribution_mean(const Distribution *dist);
+
+//===----------------------------------------------------------------------===//
+// Workload statement
+//===----------------------------------------------------------------------===//
+// Generates the jobs of an open system one at a time, in the order they arrive. The jobs are either drawn from an
+// inter-arrival and a service time distribution, or read from a trace of "ARRIVAL RUNTIME" lines sorted by arrival,
+// where blank lines and lines starting with '#' are skipped. Generation stops after job_limit jobs or at the horizon,
+// 0 means no limit.
+typedef struct Workload {
+  Distribution interarrival_;
+  Distribution service_;
+  crand_t rng_;
+  FILE *trace_;   // The jobs are read from the trace if not NULL
+  double clock_;  // The arrival of the last job, not rounded so rounding doesn't add up
+  unsigned int next_pid_;
+  size_t job_limit_;
+  int64_t horizon_;
+} Workload;
+
+Workload *workload_init(Distribution interarrival, Distribution service, uint64_t seed, size_t job_limit,
+                        int64_t horizon);
+
+// Read the jobs from a trace file. NULL if the file can't be opened.
+Workload *workload_open_trace(const char *path, size_t job_limit, int64_t horizon);
+
+void workload_destroy(Workload *workload);
+
+// Write the next job into job, false if there are no more jobs. Fits the next of a JobSource.
+bool workload_next(void *workload, Job *job);
+#endif
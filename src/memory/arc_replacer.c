@@ -0,0 +1,226 @@
+#include "memory/arc_replacer.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "memory/ghost_pool.h"
+#include "memory/index_list.h"
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// ARC Replacer Implementation
+//===----------------------------------------------------------------------===//
+enum ArcList { ARC_NONE = 0, ARC_T1 = 1, ARC_T2 = 2 };
+enum ArcGhostList { ARC_B1 = 1, ARC_B2 = 2 };
+enum ArcFrameState { ARC_LIST_MASK = 0x3, ARC_EVICTABLE = 1 << 2 };
+
+ArcReplacer *ArcReplacerInit(size_t num_frames) {
+  ArcReplacer *replacer = (ArcReplacer *)malloc(sizeof(ArcReplacer));
+  replacer->frame_links_ = (IndexLink *)malloc(sizeof(IndexLink) * num_frames);
+  replacer->frame_state_ = (uint8_t *)calloc(num_frames, sizeof(uint8_t));
+  replacer->frame_pages_ = (page_id_t *)malloc(sizeof(page_id_t) * num_frames);
+  replacer->t1_ = IndexListInit();
+  replacer->t2_ = IndexListInit();
+  replacer->b1_ = IndexListInit();
+  replacer->b2_ = IndexListInit();
+  // A victim is remembered before the ghosts are trimmed back to the pool size
+  replacer->ghosts_ = GhostPoolInit(num_frames + 1);
+  replacer->t1_target_ = 0;
+  replacer->curr_size_ = 0;
+  replacer->replacer_size_ = num_frames;
+  return replacer;
+}
+
+void ArcReplacerDestroy(ArcReplacer *replacer) {
+  free(replacer->frame_links_);
+  free(replacer->frame_state_);
+  free(replacer->frame_pages_);
+  GhostPoolDestroy(&replacer->ghosts_);
+  free(replacer);
+}
+
+static IndexList *ArcResidentList(ArcReplacer *replacer, uint8_t list) {
+  return list == ARC_T1 ? &replacer->t1_ : &replacer->t2_;
+}
+
+// Keep |T1| + |B1| <= c and |B1| + |B2| <= c, so the ghosts never outnumber the frames
+static void ArcTrimGhosts(ArcReplacer *replacer) {
+  const size_t capacity = replacer->replacer_size_;
+  while (replacer->b1_.size_ > 0 && replacer->t1_.size_ + replacer->b1_.size_ > capacity) {
+    GhostPoolPopBack(&replacer->ghosts_, &replacer->b1_);
+  }
+  while (replacer->b1_.size_ + replacer->b2_.size_ > capacity) {
+    GhostPoolPopBack(&replacer->ghosts_, replacer->b2_.size_ > 0 ? &replacer->b2_ : &replacer->b1_);
+  }
+}
+
+// Find the least recently used evictable frame of a list, -1 if there is none
+static frame_id_t ArcFindVictim(ArcReplacer *replacer, const IndexList *list) {
+  frame_id_t frame = list->tail_;
+  // Pinned frames are skipped, in the common case the tail itself is evictable
+  while (frame != -1 && !(replacer->frame_state_[frame] & ARC_EVICTABLE)) {
+    frame = replacer->frame_links_[frame].prev_;
+  }
+  return frame;
+}
+
+bool ArcReplacerEvict(ArcReplacer *replacer, frame_id_t *frame_id) {
+  // If no frame is evictable, return false directly
+  if (replacer->curr_size_ == 0) {
+    return false;
+  }
+
+  // REPLACE of ARC. The incoming page is unknown at this point, so the tie |T1| == p goes to T2.
+  const bool prefer_t1 = replacer->t1_.size_ > 0 && replacer->t1_.size_ > replacer->t1_target_;
+  uint8_t list = prefer_t1 ? ARC_T1 : ARC_T2;
+  frame_id_t victim = ArcFindVictim(replacer, ArcResidentList(replacer, list));
+  if (victim == -1) {
+    list = prefer_t1 ? ARC_T2 : ARC_T1;
+    victim = ArcFindVictim(replacer, ArcResidentList(replacer, list));
+  }
+
+  IndexListRemove(ArcResidentList(replacer, list), replacer->frame_links_, victim);
+  replacer->frame_state_[victim] = ARC_NONE;
+  if (replacer->frame_pages_[victim] != -1) {
+    IndexList *ghost_list = list == ARC_T1 ? &replacer->b1_ : &replacer->b2_;
+    GhostPoolPush(&replacer->ghosts_, ghost_list, list == ARC_T1 ? ARC_B1 : ARC_B2, replacer->frame_pages_[victim]);
+    ArcTrimGhosts(replacer);
+  }
+
+  *frame_id = victim;
+  replacer->curr_size_--;
+  return true;
+}
+
+void ArcReplacerRecordAccess(ArcReplacer *replacer, frame_id_t frame_id) {
+  // Frame id is invalid
+  if ((size_t)frame_id >= replacer->replacer_size_) {
+    fprintf(stderr, "frame_id should be less than replacer_size\n");
+    return;
+  }
+
+  uint8_t *state = &replacer->frame_state_[frame_id];
+  switch (*state & ARC_LIST_MASK) {
+    case ARC_NONE:
+      // The frame was not admitted, track it as a page of unknown identity seen once
+      replacer->frame_pages_[frame_id] = -1;
+      IndexListPushFront(&replacer->t1_, replacer->frame_links_, frame_id);
+      *state = ARC_T1;
+      break;
+    case ARC_T1:
+      // Seen twice, the page moves to T2
+      IndexListRemove(&replacer->t1_, replacer->frame_links_, frame_id);
+      IndexListPushFront(&replacer->t2_, replacer->frame_links_, frame_id);
+      *state = (uint8_t)((*state & ~ARC_LIST_MASK) | ARC_T2);
+      break;
+    default:
+      IndexListMoveToFront(&replacer->t2_, replacer->frame_links_, frame_id);
+      break;
+  }
+}
+
+void ArcReplacerSetEvictable(ArcReplacer *replacer, frame_id_t frame_id, bool set_evictable) {
+  // If the frame doesn't exist, directly return
+  if ((size_t)frame_id >= replacer->replacer_size_ ||
+      (replacer->frame_state_[frame_id] & ARC_LIST_MASK) == ARC_NONE) {
+    fprintf(stderr, "Frame %d doesn't exist\n", frame_id);
+    return;
+  }
+
+  uint8_t *state = &replacer->frame_state_[frame_id];
+  bool original_evictable = *state & ARC_EVICTABLE;
+  // If the evictable field of the given frame has not changed, return directly
+  if (set_evictable == original_evictable) {
+    return;
+  }
+
+  if (set_evictable) {
+    *state |= ARC_EVICTABLE;
+    replacer->curr_size_++;
+  } else {
+    *state &= (uint8_t)~ARC_EVICTABLE;
+    replacer->curr_size_--;
+  }
+}
+
+void ArcReplacerAdmit(ArcReplacer *replacer, frame_id_t frame_id, page_id_t page_id) {
+  // Frame id is invalid
+  if ((size_t)frame_id >= replacer->replacer_size_) {
+    fprintf(stderr, "frame_id should be less than replacer_size\n");
+    return;
+  }
+
+  uint8_t *state = &replacer->frame_state_[frame_id];
+  if ((*state & ARC_LIST_MASK) != ARC_NONE) {
+    // The frame is already tracked, re-admit it with the new page
+    IndexListRemove(ArcResidentList(replacer, *state & ARC_LIST_MASK), replacer->frame_links_, frame_id);
+  }
+  const uint8_t evictable = *state & ARC_EVICTABLE;
+  replacer->frame_pages_[frame_id] = page_id;
+
+  const int32_t ghost = GhostPoolFind(&replacer->ghosts_, page_id);
+  if (ghost == -1) {
+    IndexListPushFront(&replacer->t1_, replacer->frame_links_, frame_id);
+    *state = (uint8_t)(ARC_T1 | evictable);
+    ArcTrimGhosts(replacer);
+    return;
+  }
+
+  // A hit on a ghost list grows the side that would have kept the page
+  const size_t b1_size = replacer->b1_.size_;
+  const size_t b2_size = replacer->b2_.size_;
+  if (replacer->ghosts_.lists_[ghost] == ARC_B1) {
+    const size_t delta = b1_size >= b2_size ? 1 : b2_size / b1_size;
+    replacer->t1_target_ += delta;
+    if (replacer->t1_target_ > replacer->replacer_size_) {
+      replacer->t1_target_ = replacer->replacer_size_;
+    }
+    GhostPoolRemove(&replacer->ghosts_, &replacer->b1_, ghost);
+  } else {
+    const size_t delta = b2_size >= b1_size ? 1 : b1_size / b2_size;
+    replacer->t1_target_ = replacer->t1_target_ > delta ? replacer->t1_target_ - delta : 0;
+    GhostPoolRemove(&replacer->ghosts_, &replacer->b2_, ghost);
+  }
+  IndexListPushFront(&replacer->t2_, replacer->frame_links_, frame_id);
+  *state = (uint8_t)(ARC_T2 | evictable);
+}
+
+void ArcReplacerRecordHits(ArcReplacer *replacer, const frame_id_t *frame_ids, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    ArcReplacerRecordAccess(replacer, frame_ids[i]);
+    ArcReplacerSetEvictable(replacer, frame_ids[i], true);
+  }
+}
+
+size_t ArcReplacerSize(ArcReplacer *replacer) { return replacer->curr_size_; }
+
+size_t ArcReplacerMemoryUsage(ArcReplacer *replacer) {
+  const size_t frame_size = sizeof(IndexLink) + sizeof(uint8_t) + sizeof(page_id_t);
+  return sizeof(ArcReplacer) + replacer->replacer_size_ * frame_size + GhostPoolMemoryUsage(&replacer->ghosts_);
+}
+//===----------------------------------------------------------------------===//
+// Replacer interface implementation
+//===----------------------------------------------------------------------===//
+static bool ArcEvict(void *replacer, frame_id_t *frame_id) { return ArcReplacerEvict(replacer, frame_id); }
+
+static void ArcRecordAccess(void *replacer, frame_id_t frame_id) { ArcReplacerRecordAccess(replacer, frame_id); }
+
+static void ArcSetEvictable(void *replacer, frame_id_t frame_id, bool set_evictable) {
+  ArcReplacerSetEvictable(replacer, frame_id, set_evictable);
+}
+
+static void ArcRecordHits(void *replacer, const frame_id_t *frame_ids, size_t n) {
+  ArcReplacerRecordHits(replacer, frame_ids, n);
+}
+
+static void ArcAdmit(void *replacer, frame_id_t frame_id, page_id_t page_id) {
+  ArcReplacerAdmit(replacer, frame_id, page_id);
+}
+
+static size_t ArcSize(void *replacer) { return ArcReplacerSize(replacer); }
+
+static size_t ArcMemoryUsage(void *replacer) { return ArcReplacerMemoryUsage(replacer); }
+
+static void ArcDestroy(void *replacer) { ArcReplacerDestroy(replacer); }
+
+const ReplacerVTable ArcReplacerVTable = {ArcEvict, ArcRecordAccess, ArcRecordHits, ArcSetEvictable, ArcAdmit,
+                                          ArcSize,  ArcMemoryUsage,  ArcDestroy};
@@ -0,0 +1,77 @@
+#define _POSIX_C_SOURCE 200809L
+#include "memory/buffer_stats.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+//===----------------------------------------------------------------------===//
+// Latency Histogram Implementation
+//===----------------------------------------------------------------------===//
+uint64_t LatencyNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * UINT64_C(1000000000) + (uint64_t)now.tv_nsec;
+}
+
+// The largest latency that falls into a bucket
+static uint64_t LatencyBucketEnd(size_t bucket) {
+  if (bucket < LATENCY_SUB_BUCKET_NUM) {
+    return bucket;
+  }
+  const size_t shift = bucket / LATENCY_SUB_BUCKET_NUM - 1;
+  const uint64_t begin = (uint64_t)(LATENCY_SUB_BUCKET_NUM + bucket % LATENCY_SUB_BUCKET_NUM) << shift;
+  return begin + ((UINT64_C(1) << shift) - 1);
+}
+
+double LatencyHistogramPercentile(const LatencyHistogram *histogram, double fraction) {
+  if (histogram->count_ == 0) {
+    return 0.0;
+  }
+  // The rank of the sample, counted from 1
+  uint64_t rank = (uint64_t)(fraction * (double)histogram->count_ + 0.5);
+  if (rank == 0) {
+    rank = 1;
+  }
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < LATENCY_BUCKET_NUM; ++bucket) {
+    seen += histogram->buckets_[bucket];
+    if (seen >= rank) {
+      const uint64_t end = LatencyBucketEnd(bucket);
+      return (double)(end < histogram->max_ns_ ? end : histogram->max_ns_);
+    }
+  }
+  return (double)histogram->max_ns_;
+}
+
+//===----------------------------------------------------------------------===//
+// Buffer Stats Implementation
+//===----------------------------------------------------------------------===//
+static void BufferStatsWriteString(FILE *file, const char *string) {
+  fputc('"', file);
+  for (const char *c = string; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', file);
+    }
+    fputc(*c, file);
+  }
+  fputc('"', file);
+}
+
+void BufferStatsWriteJson(FILE *file, const char *policy_name, size_t frames_num, const BufferStats *stats) {
+  fprintf(file, "{\"policy\": ");
+  BufferStatsWriteString(file, policy_name);
+  fprintf(file, ", \"frames\": %zu, \"accesses\": %zu, \"hits\": %zu, ", frames_num, stats->access_num_,
+          stats->hit_num_);
+  fprintf(file, "\"misses\": {\"compulsory\": %zu, \"capacity\": %zu}, \"failed_fetches\": %zu, \"evictions\": %zu, ",
+          stats->compulsory_miss_num_, stats->capacity_miss_num_, stats->failed_fetch_num_, stats->eviction_num_);
+  fprintf(file, "\"evict_ns\": {\"samples\": %zu, \"mean\": %.1f, \"p50\": %.0f, \"p99\": %.0f, \"max\": %.0f}, ",
+          stats->evict_sample_num_, stats->evict_mean_ns_, stats->evict_p50_ns_, stats->evict_p99_ns_,
+          stats->evict_max_ns_);
+  fprintf(file, "\"probe_length\": {\"mean\": %.3f, \"max\": %zu}, ", stats->mean_probe_len_, stats->max_probe_len_);
+  fprintf(file, "\"bytes\": {\"page_table\": %zu, \"replacer\": %zu, \"manager\": %zu}, ", stats->page_table_bytes_,
+          stats->replacer_bytes_, stats->manager_bytes_);
+  fprintf(file, "\"prefetch\": {\"issued\": %zu, \"hits\": %zu, \"wasted\": %zu, \"pollution_misses\": %zu}}\n",
+          stats->prefetch_.issued_num_, stats->prefetch_.hit_num_, stats->prefetch_.wasted_num_,
+          stats->prefetch_.pollution_miss_num_);
+}
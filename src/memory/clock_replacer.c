@@ -0,0 +1,496 @@
+#include "memory/clock_replacer.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// CLOCK Replacer Implementation
+//===----------------------------------------------------------------------===//
+enum ClockFrameState { CLOCK_PRESENT = 1 << 0, CLOCK_EVICTABLE = 1 << 1, CLOCK_REFERENCED = 1 << 2 };
+
+ClockReplacer *ClockReplacerInit(size_t num_frames) {
+  ClockReplacer *replacer = (ClockReplacer *)malloc(sizeof(ClockReplacer));
+  replacer->frame_state_ = (uint8_t *)calloc(num_frames, sizeof(uint8_t));
+  replacer->hand_ = 0;
+  replacer->curr_size_ = 0;
+  replacer->replacer_size_ = num_frames;
+  return replacer;
+}
+
+void ClockReplacerDestroy(ClockReplacer *replacer) {
+  free(replacer->frame_state_);
+  free(replacer);
+}
+
+bool ClockReplacerEvict(ClockReplacer *replacer, frame_id_t *frame_id) {
+  // If no frame is evictable, return false directly
+  if (replacer->curr_size_ == 0) {
+    return false;
+  }
+
+  // Every evictable frame loses its reference bit in the first round, so the hand stops within two rounds
+  for (;;) {
+    const size_t frame = replacer->hand_;
+    uint8_t *state = &replacer->frame_state_[frame];
+    replacer->hand_ = frame + 1 == replacer->replacer_size_ ? 0 : frame + 1;
+    if (!(*state & CLOCK_EVICTABLE)) {
+      continue;
+    }
+    if (*state & CLOCK_REFERENCED) {
+      // Give the frame a second chance
+      *state &= (uint8_t)~CLOCK_REFERENCED;
+      continue;
+    }
+    *state = 0;
+    *frame_id = (frame_id_t)frame;
+    replacer->curr_size_--;
+    return true;
+  }
+}
+
+void ClockReplacerRecordAccess(ClockReplacer *replacer, frame_id_t frame_id) {
+  // Frame id is invalid
+  if ((size_t)frame_id >= replacer->replacer_size_) {
+    fprintf(stderr, "frame_id should be less than replacer_size\n");
+    return;
+  }
+
+  replacer->frame_state_[frame_id] |= CLOCK_PRESENT | CLOCK_REFERENCED;
+}
+
+void ClockReplacerSetEvictable(ClockReplacer *replacer, frame_id_t frame_id, bool set_evictable) {
+  // If the frame doesn't exist, directly return
+  if ((size_t)frame_id >= replacer->replacer_size_ || !(replacer->frame_state_[frame_id] & CLOCK_PRESENT)) {
+    fprintf(stderr, "Frame %d doesn't exist\n", frame_id);
+    return;
+  }
+
+  uint8_t *state = &replacer->frame_state_[frame_id];
+  bool original_evictable = *state & CLOCK_EVICTABLE;
+  // If the evictable field of the given frame has not changed, return directly
+  if (set_evictable == original_evictable) {
+    return;
+  }
+
+  if (set_evictable) {
+    *state |= CLOCK_EVICTABLE;
+    replacer->curr_size_++;
+  } else {
+    *state &= (uint8_t)~CLOCK_EVICTABLE;
+    replacer->curr_size_--;
+  }
+}
+
+void ClockReplacerAdmit(ClockReplacer *replacer, frame_id_t frame_id, page_id_t page_id) {
+  (void)page_id;
+  ClockReplacerRecordAccess(replacer, frame_id);
+}
+
+void ClockReplacerRecordHits(ClockReplacer *replacer, const frame_id_t *frame_ids, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    ClockReplacerRecordAccess(replacer, frame_ids[i]);
+    ClockReplacerSetEvictable(replacer, frame_ids[i], true);
+  }
+}
+
+size_t ClockReplacerSize(ClockReplacer *replacer) { return replacer->curr_size_; }
+
+size_t ClockReplacerMemoryUsage(ClockReplacer *replacer) {
+  return sizeof(ClockReplacer) + replacer->replacer_size_ * sizeof(uint8_t);
+}
+//===----------------------------------------------------------------------===//
+// CLOCK-Pro Replacer Implementation
+//===----------------------------------------------------------------------===//
+enum ClockProFlag {
+  CLOCKPRO_HOT = 1 << 0,
+  CLOCKPRO_TEST = 1 << 1,  // The page is cold and in its test period
+  CLOCKPRO_REFERENCED = 1 << 2,
+  CLOCKPRO_EVICTABLE = 1 << 3,
+};
+
+ClockProReplacer *ClockProReplacerInit(size_t num_frames) {
+  ClockProReplacer *replacer = (ClockProReplacer *)malloc(sizeof(ClockProReplacer));
+  // Every frame holds one resident page, and at most one non-resident page per frame is remembered
+  const size_t entry_num = 2 * num_frames + 1;
+  replacer->entries_ = (ClockProEntry *)malloc(sizeof(ClockProEntry) * entry_num);
+  replacer->frame_entry_ = (int32_t *)malloc(sizeof(int32_t) * num_frames);
+  replacer->free_entries_ = (int32_t *)malloc(sizeof(int32_t) * entry_num);
+  for (size_t i = 0; i < num_frames; ++i) {
+    replacer->frame_entry_[i] = -1;
+  }
+  for (size_t i = 0; i < entry_num; ++i) {
+    replacer->free_entries_[i] = (int32_t)(entry_num - 1 - i);
+  }
+  replacer->free_entry_num_ = entry_num;
+  replacer->ghost_table_ = ClockProGhostTable_with_capacity((intptr_t)num_frames + 1);
+  replacer->hand_hot_ = -1;
+  replacer->hand_cold_ = -1;
+  replacer->hand_test_ = -1;
+  replacer->hot_num_ = 0;
+  replacer->cold_evictable_num_ = 0;
+  replacer->non_resident_num_ = 0;
+  replacer->cold_target_ = 1;
+  replacer->curr_size_ = 0;
+  replacer->replacer_size_ = num_frames;
+  return replacer;
+}
+
+void ClockProReplacerDestroy(ClockProReplacer *replacer) {
+  free(replacer->entries_);
+  free(replacer->frame_entry_);
+  free(replacer->free_entries_);
+  ClockProGhostTable_drop(&replacer->ghost_table_);
+  free(replacer);
+}
+
+static int32_t ClockProEntryAlloc(ClockProReplacer *replacer) {
+  return replacer->free_entries_[--replacer->free_entry_num_];
+}
+
+static void ClockProEntryFree(ClockProReplacer *replacer, int32_t entry) {
+  replacer->free_entries_[replacer->free_entry_num_++] = entry;
+}
+
+// Put an entry at the head of the clock, which is right behind the hot hand
+static void ClockProLink(ClockProReplacer *replacer, int32_t entry) {
+  ClockProEntry *entries = replacer->entries_;
+  if (replacer->hand_hot_ == -1) {
+    entries[entry].prev_ = entry;
+    entries[entry].next_ = entry;
+    replacer->hand_hot_ = entry;
+    replacer->hand_cold_ = entry;
+    replacer->hand_test_ = entry;
+    return;
+  }
+  const int32_t next = replacer->hand_hot_;
+  const int32_t prev = entries[next].prev_;
+  entries[entry].prev_ = prev;
+  entries[entry].next_ = next;
+  entries[prev].next_ = entry;
+  entries[next].prev_ = entry;
+}
+
+// Take an entry off the clock, hands pointing to it move forward
+static void ClockProUnlink(ClockProReplacer *replacer, int32_t entry) {
+  ClockProEntry *entries = replacer->entries_;
+  const int32_t next = entries[entry].next_;
+  if (next == entry) {
+    replacer->hand_hot_ = -1;
+    replacer->hand_cold_ = -1;
+    replacer->hand_test_ = -1;
+    return;
+  }
+  if (replacer->hand_hot_ == entry) {
+    replacer->hand_hot_ = next;
+  }
+  if (replacer->hand_cold_ == entry) {
+    replacer->hand_cold_ = next;
+  }
+  if (replacer->hand_test_ == entry) {
+    replacer->hand_test_ = next;
+  }
+  entries[entries[entry].prev_].next_ = next;
+  entries[next].prev_ = entries[entry].prev_;
+}
+
+// Forget a non-resident page whose test period is over
+static void ClockProDropNonResident(ClockProReplacer *replacer, int32_t entry) {
+  ClockProUnlink(replacer, entry);
+  ClockProGhostTable_erase(&replacer->ghost_table_, replacer->entries_[entry].page_id_);
+  ClockProEntryFree(replacer, entry);
+  replacer->non_resident_num_--;
+}
+
+// A test period ended without a re-access, so fewer resident cold pages are needed
+static void ClockProShrinkColdTarget(ClockProReplacer *replacer) {
+  if (replacer->cold_target_ > 1) {
+    replacer->cold_target_--;
+  }
+}
+
+// A non-resident page was re-accessed during its test period, so more resident cold pages are needed
+static void ClockProGrowColdTarget(ClockProReplacer *replacer) {
+  if (replacer->cold_target_ + 1 < replacer->replacer_size_) {
+    replacer->cold_target_++;
+  }
+}
+
+// Move the hot hand until one hot page is demoted to cold, ending the test periods it passes by
+static void ClockProRunHandHot(ClockProReplacer *replacer) {
+  while (replacer->hot_num_ > 0) {
+    const int32_t entry = replacer->hand_hot_;
+    ClockProEntry *node = &replacer->entries_[entry];
+    if (node->flags_ & CLOCKPRO_HOT) {
+      replacer->hand_hot_ = node->next_;
+      if (node->flags_ & CLOCKPRO_REFERENCED) {
+        node->flags_ &= (uint8_t)~CLOCKPRO_REFERENCED;
+        continue;
+      }
+      node->flags_ &= (uint8_t)~CLOCKPRO_HOT;
+      replacer->hot_num_--;
+      if (node->flags_ & CLOCKPRO_EVICTABLE) {
+        replacer->cold_evictable_num_++;
+      }
+      return;
+    }
+    if (node->flags_ & CLOCKPRO_TEST) {
+      node->flags_ &= (uint8_t)~CLOCKPRO_TEST;
+      ClockProShrinkColdTarget(replacer);
+      if (node->fid_ == -1) {
+        // Unlinking moves the hand forward
+        ClockProDropNonResident(replacer, entry);
+        continue;
+      }
+    }
+    replacer->hand_hot_ = node->next_;
+  }
+}
+
+// Move the test hand until one non-resident page is forgotten
+static void ClockProRunHandTest(ClockProReplacer *replacer) {
+  while (replacer->non_resident_num_ > 0) {
+    const int32_t entry = replacer->hand_test_;
+    ClockProEntry *node = &replacer->entries_[entry];
+    if (node->flags_ & CLOCKPRO_TEST) {
+      node->flags_ &= (uint8_t)~CLOCKPRO_TEST;
+      ClockProShrinkColdTarget(replacer);
+      if (node->fid_ == -1) {
+        ClockProDropNonResident(replacer, entry);
+        return;
+      }
+    }
+    replacer->hand_test_ = node->next_;
+  }
+}
+
+// Keep the number of hot pages within the space left by the cold target
+static void ClockProBalance(ClockProReplacer *replacer) {
+  while (replacer->hot_num_ > 0 && replacer->hot_num_ + replacer->cold_target_ > replacer->replacer_size_) {
+    ClockProRunHandHot(replacer);
+  }
+}
+
+bool ClockProReplacerEvict(ClockProReplacer *replacer, frame_id_t *frame_id) {
+  // If no frame is evictable, return false directly
+  if (replacer->curr_size_ == 0) {
+    return false;
+  }
+
+  for (;;) {
+    // Only cold pages are evicted, demote hot pages until an evictable one turns cold
+    if (replacer->cold_evictable_num_ == 0) {
+      ClockProRunHandHot(replacer);
+      continue;
+    }
+
+    const int32_t entry = replacer->hand_cold_;
+    ClockProEntry *node = &replacer->entries_[entry];
+    if (node->fid_ == -1 || (node->flags_ & CLOCKPRO_HOT) || !(node->flags_ & CLOCKPRO_EVICTABLE)) {
+      replacer->hand_cold_ = node->next_;
+      continue;
+    }
+
+    if (node->flags_ & CLOCKPRO_REFERENCED) {
+      node->flags_ &= (uint8_t)~CLOCKPRO_REFERENCED;
+      if (node->flags_ & CLOCKPRO_TEST) {
+        // Re-accessed during its test period, the page becomes hot
+        node->flags_ = (uint8_t)((node->flags_ & ~CLOCKPRO_TEST) | CLOCKPRO_HOT);
+        replacer->hot_num_++;
+        replacer->cold_evictable_num_--;
+      } else {
+        // Start a new test period
+        node->flags_ |= CLOCKPRO_TEST;
+      }
+      ClockProUnlink(replacer, entry);
+      ClockProLink(replacer, entry);
+      ClockProBalance(replacer);
+      continue;
+    }
+
+    *frame_id = node->fid_;
+    replacer->frame_entry_[node->fid_] = -1;
+    replacer->cold_evictable_num_--;
+    replacer->curr_size_--;
+    if ((node->flags_ & CLOCKPRO_TEST) && node->page_id_ != -1) {
+      // Remember the page until its test period is over
+      node->fid_ = -1;
+      node->flags_ = CLOCKPRO_TEST;
+      ClockProGhostTable_insert(&replacer->ghost_table_, node->page_id_, entry);
+      replacer->non_resident_num_++;
+      replacer->hand_cold_ = node->next_;
+      if (replacer->non_resident_num_ > replacer->replacer_size_) {
+        ClockProRunHandTest(replacer);
+      }
+    } else {
+      ClockProUnlink(replacer, entry);
+      ClockProEntryFree(replacer, entry);
+    }
+    return true;
+  }
+}
+
+void ClockProReplacerRecordAccess(ClockProReplacer *replacer, frame_id_t frame_id) {
+  // Frame id is invalid
+  if ((size_t)frame_id >= replacer->replacer_size_) {
+    fprintf(stderr, "frame_id should be less than replacer_size\n");
+    return;
+  }
+
+  const int32_t entry = replacer->frame_entry_[frame_id];
+  if (entry == -1) {
+    // The frame was not admitted, track it as a cold page of unknown identity
+    const int32_t new_entry = ClockProEntryAlloc(replacer);
+    ClockProEntry *node = &replacer->entries_[new_entry];
+    node->page_id_ = -1;
+    node->fid_ = frame_id;
+    node->flags_ = CLOCKPRO_TEST;
+    replacer->frame_entry_[frame_id] = new_entry;
+    ClockProLink(replacer, new_entry);
+    return;
+  }
+
+  replacer->entries_[entry].flags_ |= CLOCKPRO_REFERENCED;
+}
+
+void ClockProReplacerSetEvictable(ClockProReplacer *replacer, frame_id_t frame_id, bool set_evictable) {
+  // If the frame doesn't exist, directly return
+  if ((size_t)frame_id >= replacer->replacer_size_ || replacer->frame_entry_[frame_id] == -1) {
+    fprintf(stderr, "Frame %d doesn't exist\n", frame_id);
+    return;
+  }
+
+  ClockProEntry *node = &replacer->entries_[replacer->frame_entry_[frame_id]];
+  bool original_evictable = node->flags_ & CLOCKPRO_EVICTABLE;
+  // If the evictable field of the given frame has not changed, return directly
+  if (set_evictable == original_evictable) {
+    return;
+  }
+
+  const bool is_cold = !(node->flags_ & CLOCKPRO_HOT);
+  if (set_evictable) {
+    node->flags_ |= CLOCKPRO_EVICTABLE;
+    replacer->cold_evictable_num_ += is_cold;
+    replacer->curr_size_++;
+  } else {
+    node->flags_ &= (uint8_t)~CLOCKPRO_EVICTABLE;
+    replacer->cold_evictable_num_ -= is_cold;
+    replacer->curr_size_--;
+  }
+}
+
+void ClockProReplacerAdmit(ClockProReplacer *replacer, frame_id_t frame_id, page_id_t page_id) {
+  // Frame id is invalid
+  if ((size_t)frame_id >= replacer->replacer_size_) {
+    fprintf(stderr, "frame_id should be less than replacer_size\n");
+    return;
+  }
+
+  int32_t entry = replacer->frame_entry_[frame_id];
+  uint8_t evictable = 0;
+  if (entry == -1) {
+    entry = ClockProEntryAlloc(replacer);
+    replacer->frame_entry_[frame_id] = entry;
+  } else {
+    // The frame is already tracked, re-admit it at the head of the clock
+    evictable = replacer->entries_[entry].flags_ & CLOCKPRO_EVICTABLE;
+    if (evictable && !(replacer->entries_[entry].flags_ & CLOCKPRO_HOT)) {
+      replacer->cold_evictable_num_--;
+    }
+    if (replacer->entries_[entry].flags_ & CLOCKPRO_HOT) {
+      replacer->hot_num_--;
+    }
+    ClockProUnlink(replacer, entry);
+  }
+
+  ClockProEntry *node = &replacer->entries_[entry];
+  node->page_id_ = page_id;
+  node->fid_ = frame_id;
+  const ClockProGhostTable_value *ghost = ClockProGhostTable_get(&replacer->ghost_table_, page_id);
+  if (ghost != NULL) {
+    // Re-accessed during its test period, the page comes back as hot
+    ClockProDropNonResident(replacer, ghost->second);
+    ClockProGrowColdTarget(replacer);
+    node->flags_ = (uint8_t)(CLOCKPRO_HOT | evictable);
+    replacer->hot_num_++;
+  } else {
+    node->flags_ = (uint8_t)(CLOCKPRO_TEST | evictable);
+    if (evictable) {
+      replacer->cold_evictable_num_++;
+    }
+  }
+  ClockProLink(replacer, entry);
+  ClockProBalance(replacer);
+}
+
+void ClockProReplacerRecordHits(ClockProReplacer *replacer, const frame_id_t *frame_ids, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    ClockProReplacerRecordAccess(replacer, frame_ids[i]);
+    ClockProReplacerSetEvictable(replacer, frame_ids[i], true);
+  }
+}
+
+size_t ClockProReplacerSize(ClockProReplacer *replacer) { return replacer->curr_size_; }
+
+size_t ClockProReplacerMemoryUsage(ClockProReplacer *replacer) {
+  const size_t entry_num = 2 * replacer->replacer_size_ + 1;
+  const size_t bucket_num = (size_t)replacer->ghost_table_.bucket_count;
+  return sizeof(ClockProReplacer) + entry_num * (sizeof(ClockProEntry) + sizeof(int32_t)) +
+         replacer->replacer_size_ * sizeof(int32_t) + bucket_num * sizeof(ClockProGhostTable_value) +
+         (bucket_num + 1) * sizeof(struct chash_slot);
+}
+//===----------------------------------------------------------------------===//
+// Replacer interface implementation
+//===----------------------------------------------------------------------===//
+static bool ClockEvict(void *replacer, frame_id_t *frame_id) { return ClockReplacerEvict(replacer, frame_id); }
+
+static void ClockRecordAccess(void *replacer, frame_id_t frame_id) { ClockReplacerRecordAccess(replacer, frame_id); }
+
+static void ClockSetEvictable(void *replacer, frame_id_t frame_id, bool set_evictable) {
+  ClockReplacerSetEvictable(replacer, frame_id, set_evictable);
+}
+
+static void ClockRecordHits(void *replacer, const frame_id_t *frame_ids, size_t n) {
+  ClockReplacerRecordHits(replacer, frame_ids, n);
+}
+
+static void ClockAdmit(void *replacer, frame_id_t frame_id, page_id_t page_id) {
+  ClockReplacerAdmit(replacer, frame_id, page_id);
+}
+
+static size_t ClockSize(void *replacer) { return ClockReplacerSize(replacer); }
+
+static size_t ClockMemoryUsage(void *replacer) { return ClockReplacerMemoryUsage(replacer); }
+
+static void ClockDestroy(void *replacer) { ClockReplacerDestroy(replacer); }
+
+const ReplacerVTable ClockReplacerVTable = {ClockEvict, ClockRecordAccess, ClockRecordHits, ClockSetEvictable,
+                                            ClockAdmit, ClockSize,         ClockMemoryUsage, ClockDestroy};
+
+static bool ClockProEvict(void *replacer, frame_id_t *frame_id) { return ClockProReplacerEvict(replacer, frame_id); }
+
+static void ClockProRecordAccess(void *replacer, frame_id_t frame_id) {
+  ClockProReplacerRecordAccess(replacer, frame_id);
+}
+
+static void ClockProRecordHits(void *replacer, const frame_id_t *frame_ids, size_t n) {
+  ClockProReplacerRecordHits(replacer, frame_ids, n);
+}
+
+static void ClockProSetEvictable(void *replacer, frame_id_t frame_id, bool set_evictable) {
+  ClockProReplacerSetEvictable(replacer, frame_id, set_evictable);
+}
+
+static void ClockProAdmit(void *replacer, frame_id_t frame_id, page_id_t page_id) {
+  ClockProReplacerAdmit(replacer, frame_id, page_id);
+}
+
+static size_t ClockProSize(void *replacer) { return ClockProReplacerSize(replacer); }
+
+static size_t ClockProMemoryUsage(void *replacer) { return ClockProReplacerMemoryUsage(replacer); }
+
+static void ClockProDestroy(void *replacer) { ClockProReplacerDestroy(replacer); }
+
+const ReplacerVTable ClockProReplacerVTable = {ClockProEvict,        ClockProRecordAccess, ClockProRecordHits,
+                                               ClockProSetEvictable, ClockProAdmit,        ClockProSize,
+                                               ClockProMemoryUsage,  ClockProDestroy};
@@ -1,142 +1,582 @@
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "argparse.h"
+#include "memory/arc_replacer.h"
 #include "memory/buffer_manager.h"
+#include "memory/buffer_stats.h"
+#include "memory/clock_replacer.h"
+#include "memory/opt_simulator.h"
+#include "memory/page_store.h"
+#include "memory/page_trace.h"
+#include "memory/prefetcher.h"
 #include "memory/replacer.h"
+#include "memory/sharded_buffer_manager.h"
+#include "memory/stack_distance.h"
+#include "memory/stress.h"
+#include "memory/sweep.h"
+#include "memory/two_queue_replacer.h"
 
-const unsigned int INSTRUCTIONS_NUM = 320;
+#define INSTRUCTIONS_NUM 320
+// Number of accesses read from the workload at a time
+#define WORKLOAD_BATCH_SIZE 4096
+// Size of the pages of a page store
+#define STORE_PAGE_SIZE 4096
+// Number of streams the prefetcher follows at once
+#define PREFETCH_STREAM_NUM 8
+
+// The version last written to every page of a page store
+#define i_type PageVersions
+#define i_key page_id_t
+#define i_val uint64_t
+#include "stc/cmap.h"
+
+// The reference string replayed by every policy, either generated from the seed or streamed from a trace file
+typedef struct Workload {
+  page_id_t *pages;         // The generated reference string, NULL when a trace file is replayed
+  PageTraceReader *reader;  // The trace file, NULL when the reference string is generated
+  page_id_t *decoded;       // The trace decoded once for OPT, NULL until OPT first needs it
+  size_t access_num;
+  size_t cursor;
+} Workload;
 
 // Generate the index of instruction
-size_t generate_index(size_t lower, size_t upper);
+size_t generate_index(crand_t *rng, size_t lower, size_t upper);
+
+// Generate a reference string of INSTRUCTIONS_NUM pages
+void generate_trace(crand_t *rng, page_id_t *trace);
+
+// Restart the workload from its first access
+void workload_rewind(Workload *workload);
+
+// Read up to n accesses of the workload, 0 at its end
+size_t workload_read(Workload *workload, page_id_t *pages, size_t n);
+
+// Replay the workload on the given buffer manager and print its missing rate. The pages of the last pinned_num
+// accesses stay pinned, like pages held by a scan, and a fetch fails when every frame is pinned. With a page store
+// every access checks and rewrites the data of its page, which must start empty. With json_stats every statistic of
+// the buffer manager is printed as one line of JSON instead.
+void epoch(BufferManager *manager, const char *policy_name, Workload *workload, size_t pinned_num, bool json_stats);
+
+// Check that a page holds the version last written to it and write the next one, false if it doesn't
+bool write_page(BufferManager *manager, frame_id_t frame_id, page_id_t page_id, PageVersions *versions);
+
+// OPT knows the whole reference string in advance, so it is simulated without a buffer manager and with json_stats
+// only its hits and misses are known
+void opt_epoch(size_t frames_num, Workload *workload, bool json_stats);
+
+// Print the LRU missing rate of every memory size up to max_frames_num from a single pass over the workload
+void lru_curve(size_t max_frames_num, Workload *workload);
+
+// Save the workload as a page trace file
+void record_workload(const char *path, Workload *workload);
+
+// Replay every policy on memory sizes 4 to max_frames_num for seed_num seeds on thread_num threads and print the
+// missing rates as CSV, in the same order whatever the number of threads
+void sweep(size_t max_frames_num, int seed, size_t seed_num, size_t thread_num, const char *trace_path);
+
+// Fetch access_num random pages on each of thread_num threads through a sharded buffer manager for every policy, first
+// from a working set that fills the pool exactly and then from one four times larger. Print the throughput and return
+// false if the hits and misses the manager counted don't add up to the accesses. With buffered_hits hits are looked up
+// without locks and handed to the replacers in batches.
+bool stress(size_t frames_num, size_t shard_num, size_t thread_num, size_t access_num, bool buffered_hits, int seed);
+
+AnyReplacer create_fifo_replacer(size_t frames_num);
+
+AnyReplacer create_lru_1_replacer(size_t frames_num);
 
-void lru_epoch(size_t frames_num, size_t replacer_k);
+AnyReplacer create_lru_3_replacer(size_t frames_num);
 
-void fifo_epoch(size_t frames_num);
+AnyReplacer create_clock_replacer(size_t frames_num);
+
+AnyReplacer create_clock_pro_replacer(size_t frames_num);
+
+AnyReplacer create_arc_replacer(size_t frames_num);
+
+AnyReplacer create_two_queue_replacer(size_t frames_num);
+
+const SweepPolicy POLICIES[] = {{"FIFO", create_fifo_replacer},
+                                {"LRU-1", create_lru_1_replacer},
+                                {"LRU-3", create_lru_3_replacer},
+                                {"CLOCK", create_clock_replacer},
+                                {"CLOCK-Pro", create_clock_pro_replacer},
+                                {"ARC", create_arc_replacer},
+                                {"2Q", create_two_queue_replacer},
+                                {"OPT", NULL}};
+const size_t POLICY_NUM = sizeof(POLICIES) / sizeof(POLICIES[0]);
 
 int main(int argc, const char *argv[]) {
   if (argc < 2) {
-    fprintf(stderr, "Usage: memory --random seed\n");
+    fprintf(stderr, "Usage: memory --seed seed | --trace file | --stress accesses\n");
     exit(EXIT_FAILURE);
   }
   int seed = 0;
+  int curve_frames_num = 0;
+  const char *trace_path = NULL;
+  const char *record_path = NULL;
+  int sweep_seed_num = 0;
+  int max_frames_num = 32;
+  int thread_num = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int stress_access_num = 0;
+  int stress_frames_num = 4096;
+  int shard_num = 16;
+  int buffered_hits = 0;
+  int pinned_num = 0;
+  const char *store_path = NULL;
+  int read_ahead = 0;
+  const char *stats_format = NULL;
   // Parse the command line
-  struct argparse_option options[] = {OPT_HELP(), OPT_INTEGER('s', "seed", &seed, "random seed", NULL, 0, 0),
-                                      OPT_END()};
+  struct argparse_option options[] = {
+      OPT_HELP(), OPT_INTEGER('s', "seed", &seed, "random seed", NULL, 0, 0),
+      OPT_INTEGER('c', "curve", &curve_frames_num, "print the LRU miss ratio curve up to this many frames", NULL, 0, 0),
+      OPT_STRING('t', "trace", &trace_path, "replay a page trace file instead of a generated reference string", NULL,
+                 0, 0),
+      OPT_STRING('w', "write-trace", &record_path, "save the replayed reference string as a page trace file", NULL, 0,
+                 0),
+      OPT_INTEGER('p', "pinned", &pinned_num, "keep the pages of this many most recent accesses pinned", NULL, 0, 0),
+      OPT_STRING('d', "store", &store_path, "back the frames with pages in this file and write every accessed page",
+                 NULL, 0, 0),
+      OPT_INTEGER('r', "read-ahead", &read_ahead, "prefetch this many pages ahead of sequential and strided accesses",
+                  NULL, 0, 0),
+      OPT_STRING(0, "stats", &stats_format, "print every statistic of each replay in this format, json", NULL, 0, 0),
+      OPT_INTEGER('S', "sweep", &sweep_seed_num, "sweep every policy and memory size over this many seeds", NULL, 0,
+                  0),
+      OPT_INTEGER('m', "max-frames", &max_frames_num, "largest memory size of the sweep", NULL, 0, 0),
+      OPT_INTEGER('j', "threads", &thread_num, "number of threads of the sweep or the stress test", NULL, 0, 0),
+      OPT_INTEGER('T', "stress", &stress_access_num, "stress a sharded buffer manager with this many accesses a thread",
+                  NULL, 0, 0),
+      OPT_INTEGER('f', "frames", &stress_frames_num, "number of frames of the stress test", NULL, 0, 0),
+      OPT_INTEGER('n', "shards", &shard_num, "number of shards of the stress test", NULL, 0, 0),
+      OPT_BOOLEAN('b', "buffered", &buffered_hits, "look hits up without locks and buffer them per thread",
+                  NULL, 0, 0),
+      OPT_END()};
   struct argparse parse;
   argparse_init(&parse, options, NULL, 0);
   argc = argparse_parse(&parse, argc, argv);
-  srand(seed);
+  if (stats_format != NULL && strcmp(stats_format, "json") != 0) {
+    fprintf(stderr, "Unknown stats format %s, only json is supported\n", stats_format);
+    exit(EXIT_FAILURE);
+  }
+  const bool json_stats = stats_format != NULL;
+  if (sweep_seed_num > 0) {
+    sweep(max_frames_num, seed, sweep_seed_num, thread_num > 0 ? thread_num : 1, trace_path);
+    return 0;
+  }
+  if (stress_access_num > 0) {
+    if (stress_frames_num <= 0) {
+      fprintf(stderr, "The stress test needs at least one frame\n");
+      exit(EXIT_FAILURE);
+    }
+    const bool exact = stress(stress_frames_num, shard_num > 0 ? shard_num : 1, thread_num > 0 ? thread_num : 1,
+                              stress_access_num, buffered_hits, seed);
+    return exact ? 0 : EXIT_FAILURE;
+  }
+
+  // Every policy and memory size replays the same reference string
+  Workload workload = {NULL, NULL, NULL, 0, 0};
+  if (trace_path != NULL) {
+    workload.reader = PageTraceReaderOpen(trace_path);
+    if (workload.reader == NULL) {
+      exit(EXIT_FAILURE);
+    }
+    workload.access_num = PageTraceReaderSize(workload.reader);
+  } else {
+    crand_t rng = crand_init((uint64_t)seed);
+    workload.pages = (page_id_t *)malloc(INSTRUCTIONS_NUM * sizeof(page_id_t));
+    generate_trace(&rng, workload.pages);
+    workload.access_num = INSTRUCTIONS_NUM;
+  }
+  if (record_path != NULL) {
+    record_workload(record_path, &workload);
+  }
 
-  unsigned int *instructions = (unsigned int *)malloc(INSTRUCTIONS_NUM * sizeof(unsigned int));
-  for (int i = 0; i < 320; i++) instructions[i] = i;
+  if (curve_frames_num > 0) {
+    lru_curve(curve_frames_num, &workload);
+  } else {
+    for (int i = 4; i < 33; ++i) {
+      if (!json_stats) {
+        printf("Current Memory Size: %d Frames\n", i);
+      }
+      for (size_t policy = 0; policy < POLICY_NUM; ++policy) {
+        if (POLICIES[policy].create_replacer_ == NULL) {
+          opt_epoch(i, &workload, json_stats);
+        } else {
+          PageStore *store = NULL;
+          if (store_path != NULL) {
+            // Every replay starts from an empty page store
+            remove(store_path);
+            store = PageStoreOpen(store_path, STORE_PAGE_SIZE, 1);
+            if (store == NULL) {
+              exit(EXIT_FAILURE);
+            }
+          }
+          BufferManager *manager = store == NULL
+                                       ? BufferManagerInit(i, POLICIES[policy].create_replacer_(i))
+                                       : BufferManagerInitWithStore(i, POLICIES[policy].create_replacer_(i), store);
+          if (read_ahead > 0) {
+            BufferManagerSetPrefetcher(manager, PrefetcherInit(PREFETCH_STREAM_NUM, read_ahead));
+          }
+          epoch(manager, POLICIES[policy].name_, &workload, pinned_num > 0 ? pinned_num : 0, json_stats);
+          BufferManagerDestroy(manager);
+          if (store != NULL) {
+            PageStoreClose(store);
+          }
+        }
+      }
+      if (!json_stats) {
+        printf("\n\n");
+      }
+    }
+  }
 
-  for (int i = 4; i < 33; ++i) {
-    printf("Current Memory Size: %d Frames\n", i);
-    fifo_epoch(i);
-    lru_epoch(i, 1);
-    lru_epoch(i, 3);
-    printf("\n\n");
+  if (workload.reader != NULL) {
+    PageTraceReaderClose(workload.reader);
   }
-  free(instructions);
+  free(workload.pages);
+  free(workload.decoded);
   return 0;
 }
 
-size_t generate_index(size_t lower, size_t upper) { return (rand() % (upper - lower + 1)) + lower; }
+size_t generate_index(crand_t *rng, size_t lower, size_t upper) {
+  // m'+2 may lie past the last instruction
+  if (lower > upper) {
+    lower = upper;
+  }
+  return (crand_u64(rng) % (upper - lower + 1)) + lower;
+}
 
-void lru_epoch(size_t frames_num, size_t replacer_k) {
-  const size_t PAGE_SIZE = 10;
-  LRUBufferManager *manager = LRUBufferManagerInit(frames_num, replacer_k);
-  int access_num = 0;
-  while ((unsigned int)access_num < INSTRUCTIONS_NUM) {
-    // Random generate a start index
-    size_t start = generate_index(0, INSTRUCTIONS_NUM);
-    // Execute instruction at m+1
-    page_id_t access_page = (start + 1) / PAGE_SIZE;
-    frame_id_t frame = LRUBufferManagerFetchPage(manager, access_page);
-    if (frame == -1) {
-      fprintf(stderr, "Error: Something wrong in FetchPage\n");
-    }
-    access_num++;
-    // Random pick a instruction between 0 and m+1
-    size_t forward_jump = generate_index(0, start + 1);
-    // Execute instruction at m'
-    access_page = forward_jump / PAGE_SIZE;
-    frame = LRUBufferManagerFetchPage(manager, access_page);
-    if (frame == -1) {
-      fprintf(stderr, "Error: Something wrong in FetchPage\n");
-    }
-    access_num++;
-    // Execute instruction at m'+1
-    access_page = (forward_jump + 1) / PAGE_SIZE;
-    frame = LRUBufferManagerFetchPage(manager, access_page);
-    if (frame == -1) {
-      fprintf(stderr, "Error: Something wrong in FetchPage\n");
+AnyReplacer create_fifo_replacer(size_t frames_num) { return FIFOReplacerAsAny(FIFOReplacerInit(frames_num)); }
+
+AnyReplacer create_lru_1_replacer(size_t frames_num) { return ReplacerAsAny(ReplacerInit(frames_num, 1)); }
+
+AnyReplacer create_lru_3_replacer(size_t frames_num) { return ReplacerAsAny(ReplacerInit(frames_num, 3)); }
+
+AnyReplacer create_clock_replacer(size_t frames_num) { return ClockReplacerAsAny(ClockReplacerInit(frames_num)); }
+
+AnyReplacer create_clock_pro_replacer(size_t frames_num) {
+  return ClockProReplacerAsAny(ClockProReplacerInit(frames_num));
+}
+
+AnyReplacer create_arc_replacer(size_t frames_num) { return ArcReplacerAsAny(ArcReplacerInit(frames_num)); }
+
+AnyReplacer create_two_queue_replacer(size_t frames_num) {
+  return TwoQueueReplacerAsAny(TwoQueueReplacerInit(frames_num));
+}
+
+void opt_epoch(size_t frames_num, Workload *workload, bool json_stats) {
+  // A trace file is decoded into memory, OPT needs every next use anyway. Every memory size reuses it.
+  if (workload->pages == NULL && workload->decoded == NULL) {
+    workload->decoded = (page_id_t *)malloc(sizeof(page_id_t) * workload->access_num);
+    workload_rewind(workload);
+    workload_read(workload, workload->decoded, workload->access_num);
+  }
+  const page_id_t *pages = workload->pages != NULL ? workload->pages : workload->decoded;
+  size_t compulsory_miss_num = 0;
+  size_t capacity_miss_num = 0;
+  OptSimulate(pages, workload->access_num, frames_num, &compulsory_miss_num, &capacity_miss_num);
+  if (json_stats) {
+    BufferStats stats = {0};
+    stats.access_num_ = workload->access_num;
+    stats.hit_num_ = workload->access_num - compulsory_miss_num - capacity_miss_num;
+    stats.compulsory_miss_num_ = compulsory_miss_num;
+    stats.capacity_miss_num_ = capacity_miss_num;
+    stats.eviction_num_ = capacity_miss_num;
+    BufferStatsWriteJson(stdout, "OPT", frames_num, &stats);
+  } else {
+    printf("OPT Missing Rate: %.2lf\n", (double)(compulsory_miss_num + capacity_miss_num) / workload->access_num);
+  }
+}
+
+void lru_curve(size_t max_frames_num, Workload *workload) {
+  StackDistanceAnalyzer *analyzer = StackDistanceAnalyzerInit(max_frames_num);
+  page_id_t pages[WORKLOAD_BATCH_SIZE];
+  size_t read_num;
+  workload_rewind(workload);
+  while ((read_num = workload_read(workload, pages, WORKLOAD_BATCH_SIZE)) > 0) {
+    for (size_t i = 0; i < read_num; ++i) {
+      StackDistanceAnalyzerAccess(analyzer, pages[i]);
     }
-    access_num++;
-    // Random pick a instruction between m'+2 and 319
-    size_t backward_jump = generate_index(forward_jump + 2, INSTRUCTIONS_NUM);
-    access_page = backward_jump / PAGE_SIZE;
-    frame = LRUBufferManagerFetchPage(manager, access_page);
-    if (frame == -1) {
-      fprintf(stderr, "Error: Something wrong in FetchPage\n");
+  }
+
+  size_t *miss_num = (size_t *)malloc(sizeof(size_t) * max_frames_num);
+  StackDistanceAnalyzerMissCurve(analyzer, miss_num);
+  for (size_t frames_num = 1; frames_num <= max_frames_num; ++frames_num) {
+    printf("%zu Frames LRU Missing Rate: %.2lf\n", frames_num,
+           (double)miss_num[frames_num - 1] / workload->access_num);
+  }
+  free(miss_num);
+  StackDistanceAnalyzerDestroy(analyzer);
+}
+
+void record_workload(const char *path, Workload *workload) {
+  PageTraceWriter *writer = PageTraceWriterOpen(path);
+  if (writer == NULL) {
+    exit(EXIT_FAILURE);
+  }
+  page_id_t pages[WORKLOAD_BATCH_SIZE];
+  size_t read_num;
+  bool succeed = true;
+  workload_rewind(workload);
+  while ((read_num = workload_read(workload, pages, WORKLOAD_BATCH_SIZE)) > 0) {
+    for (size_t i = 0; i < read_num; ++i) {
+      succeed = PageTraceWriterAppend(writer, pages[i]) && succeed;
     }
-    access_num++;
   }
+  if (!PageTraceWriterClose(writer) || !succeed) {
+    exit(EXIT_FAILURE);
+  }
+}
 
-  size_t compulsory_miss_num = 0;
-  size_t capacity_miss_num = 0;
-  LRUBufferManagerGetMissNum(manager, &compulsory_miss_num, &capacity_miss_num);
-  printf("LRU-%zu Missing Rate: %.2lf\n", replacer_k,
-         (double)(compulsory_miss_num + capacity_miss_num) / INSTRUCTIONS_NUM);
+void sweep(size_t max_frames_num, int seed, size_t seed_num, size_t thread_num, const char *trace_path) {
+  // A trace file is the same for every seed
+  if (trace_path != NULL) {
+    seed_num = 1;
+  }
+  const size_t frames_num_per_seed = max_frames_num >= 4 ? max_frames_num - 3 : 0;
+  const size_t config_num = seed_num * frames_num_per_seed * POLICY_NUM;
+  SweepConfig *configs = (SweepConfig *)malloc(sizeof(SweepConfig) * config_num);
+  size_t config_index = 0;
+  for (size_t seed_offset = 0; seed_offset < seed_num; ++seed_offset) {
+    for (size_t frames_num = 4; frames_num <= max_frames_num; ++frames_num) {
+      for (size_t policy = 0; policy < POLICY_NUM; ++policy) {
+        SweepConfig *config = &configs[config_index++];
+        config->policy_ = &POLICIES[policy];
+        config->frames_num_ = frames_num;
+        config->seed_ = (uint64_t)seed + seed_offset;
+        config->miss_num_ = 0;
+        config->access_num_ = 0;
+      }
+    }
+  }
 
-  LRUBufferManagerDestroy(manager);
+  const SweepWorkload workload = {trace_path, generate_trace, INSTRUCTIONS_NUM};
+  if (!SweepRun(configs, config_num, &workload, thread_num)) {
+    free(configs);
+    exit(EXIT_FAILURE);
+  }
+  printf("policy,frames,seed,missing_rate\n");
+  for (size_t i = 0; i < config_num; ++i) {
+    printf("%s,%zu,%llu,%.4lf\n", configs[i].policy_->name_, configs[i].frames_num_,
+           (unsigned long long)configs[i].seed_, (double)configs[i].miss_num_ / configs[i].access_num_);
+  }
+  free(configs);
 }
 
-void fifo_epoch(size_t frames_num) {
+void generate_trace(crand_t *rng, page_id_t *trace) {
   const size_t PAGE_SIZE = 10;
-  FIFOBufferManager *manager = FIFOBufferManagerInit(frames_num);
-  int access_num = 0;
-  while ((unsigned int)access_num < INSTRUCTIONS_NUM) {
+  size_t access_num = 0;
+  while (access_num < INSTRUCTIONS_NUM) {
     // Random generate a start index
-    size_t start = generate_index(0, INSTRUCTIONS_NUM);
+    size_t start = generate_index(rng, 0, INSTRUCTIONS_NUM);
     // Execute instruction at m+1
-    page_id_t access_page = (start + 1) / PAGE_SIZE;
-    frame_id_t frame = FIFOBufferManagerFetchPage(manager, access_page);
-    if (frame == -1) {
-      fprintf(stderr, "Error: Something wrong in FetchPage\n");
-    }
-    access_num++;
+    trace[access_num++] = (start + 1) / PAGE_SIZE;
     // Random pick a instruction between 0 and m+1
-    size_t forward_jump = generate_index(0, start + 1);
+    size_t forward_jump = generate_index(rng, 0, start + 1);
     // Execute instruction at m'
-    access_page = forward_jump / PAGE_SIZE;
-    frame = FIFOBufferManagerFetchPage(manager, access_page);
-    if (frame == -1) {
-      fprintf(stderr, "Error: Something wrong in FetchPage\n");
-    }
-    access_num++;
+    trace[access_num++] = forward_jump / PAGE_SIZE;
     // Execute instruction at m'+1
-    access_page = (forward_jump + 1) / PAGE_SIZE;
-    frame = FIFOBufferManagerFetchPage(manager, access_page);
-    if (frame == -1) {
-      fprintf(stderr, "Error: Something wrong in FetchPage\n");
-    }
-    access_num++;
+    trace[access_num++] = (forward_jump + 1) / PAGE_SIZE;
     // Random pick a instruction between m'+2 and 319
-    size_t backward_jump = generate_index(forward_jump + 2, INSTRUCTIONS_NUM);
-    access_page = backward_jump / PAGE_SIZE;
-    frame = FIFOBufferManagerFetchPage(manager, access_page);
-    if (frame == -1) {
-      fprintf(stderr, "Error: Something wrong in FetchPage\n");
+    size_t backward_jump = generate_index(rng, forward_jump + 2, INSTRUCTIONS_NUM);
+    trace[access_num++] = backward_jump / PAGE_SIZE;
+  }
+}
+
+void workload_rewind(Workload *workload) {
+  workload->cursor = 0;
+  if (workload->reader != NULL) {
+    PageTraceReaderRewind(workload->reader);
+  }
+}
+
+size_t workload_read(Workload *workload, page_id_t *pages, size_t n) {
+  if (workload->reader != NULL) {
+    return PageTraceReaderRead(workload->reader, pages, n);
+  }
+  if (n > workload->access_num - workload->cursor) {
+    n = workload->access_num - workload->cursor;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    pages[i] = workload->pages[workload->cursor + i];
+  }
+  workload->cursor += n;
+  return n;
+}
+
+void epoch(BufferManager *manager, const char *policy_name, Workload *workload, size_t pinned_num, bool json_stats) {
+  page_id_t pages[WORKLOAD_BATCH_SIZE];
+  frame_id_t frames[WORKLOAD_BATCH_SIZE];
+  size_t read_num;
+  // The pinned pages in access order, a ring of the last pinned_num successful fetches
+  page_id_t *pinned_pages = (page_id_t *)malloc(sizeof(page_id_t) * (pinned_num > 0 ? pinned_num : 1));
+  size_t pinned_begin = 0;
+  size_t pinned_size = 0;
+  size_t failed_num = 0;
+  PageVersions versions = PageVersions_init();
+  size_t corrupted_num = 0;
+  workload_rewind(workload);
+  while ((read_num = workload_read(workload, pages, WORKLOAD_BATCH_SIZE)) > 0) {
+    if (pinned_num == 0 && manager->store_ == NULL) {
+      BufferManagerFetchPages(manager, pages, read_num, frames);
+      for (size_t i = 0; i < read_num; ++i) {
+        if (frames[i] == -1) {
+          fprintf(stderr, "Error: Something wrong in FetchPage\n");
+        }
+      }
+      continue;
+    }
+    for (size_t i = 0; i < read_num; ++i) {
+      if (pinned_num > 0 && pinned_size == pinned_num) {
+        BufferManagerUnpinPage(manager, pinned_pages[pinned_begin]);
+        pinned_begin = (pinned_begin + 1) % pinned_num;
+        pinned_size--;
+      }
+      const frame_id_t frame_id = BufferManagerFetchPage(manager, pages[i]);
+      if (frame_id == -1) {
+        failed_num++;
+        continue;
+      }
+      if (manager->store_ != NULL && !write_page(manager, frame_id, pages[i], &versions)) {
+        corrupted_num++;
+      }
+      if (pinned_num > 0) {
+        pinned_pages[(pinned_begin + pinned_size++) % pinned_num] = pages[i];
+      } else {
+        BufferManagerUnpinPage(manager, pages[i]);
+      }
     }
-    access_num++;
   }
+  for (; pinned_size > 0; --pinned_size) {
+    BufferManagerUnpinPage(manager, pinned_pages[pinned_begin]);
+    pinned_begin = (pinned_begin + 1) % pinned_num;
+  }
+  free(pinned_pages);
+  PageVersions_drop(&versions);
 
+  if (json_stats) {
+    if (corrupted_num > 0) {
+      fprintf(stderr, "%s: %zu pages read back wrong\n", policy_name, corrupted_num);
+    }
+    BufferStats stats;
+    BufferManagerGetStats(manager, &stats);
+    BufferStatsWriteJson(stdout, policy_name, manager->pool_size, &stats);
+    return;
+  }
   size_t compulsory_miss_num = 0;
   size_t capacity_miss_num = 0;
-  FIFOBufferManagerGetMissNum(manager, &compulsory_miss_num, &capacity_miss_num);
-  printf("FIFO Missing Rate: %.2lf\n", (double)(compulsory_miss_num + capacity_miss_num) / INSTRUCTIONS_NUM);
+  BufferManagerGetMissNum(manager, &compulsory_miss_num, &capacity_miss_num);
+  printf("%s Missing Rate: %.2lf", policy_name,
+         (double)(compulsory_miss_num + capacity_miss_num) / workload->access_num);
+  if (failed_num > 0) {
+    printf(", %zu fetches failed with every frame pinned", failed_num);
+  }
+  if (corrupted_num > 0) {
+    printf(", %zu pages read back wrong", corrupted_num);
+  }
+  if (manager->prefetcher_ != NULL) {
+    PrefetchStats stats;
+    BufferManagerGetPrefetchStats(manager, &stats);
+    printf(", %zu prefetched: %zu hits, %zu wasted, %zu pollution misses", stats.issued_num_, stats.hit_num_,
+           stats.wasted_num_, stats.pollution_miss_num_);
+  }
+  printf("\n");
+}
+
+bool write_page(BufferManager *manager, frame_id_t frame_id, page_id_t page_id, PageVersions *versions) {
+  // A page starts with its version and its id, a page never written is all zeros
+  uint8_t *data = BufferManagerGetPageData(manager, frame_id);
+  uint64_t version;
+  page_id_t stored_page_id;
+  memcpy(&version, data, sizeof(version));
+  memcpy(&stored_page_id, data + sizeof(version), sizeof(stored_page_id));
+  PageVersions_result expected = PageVersions_insert(versions, page_id, 0);
+  const bool intact = version == expected.ref->second && (version == 0 || stored_page_id == page_id);
+
+  expected.ref->second++;
+  memcpy(data, &expected.ref->second, sizeof(expected.ref->second));
+  memcpy(data + sizeof(version), &page_id, sizeof(page_id));
+  BufferManagerMarkDirty(manager, page_id);
+  return intact;
+}
 
-  FIFOBufferManagerDestroy(manager);
+bool stress(size_t frames_num, size_t shard_num, size_t thread_num, size_t access_num, bool buffered_hits, int seed) {
+  page_id_t **pages = (page_id_t **)malloc(sizeof(page_id_t *) * thread_num);
+  for (size_t thread = 0; thread < thread_num; ++thread) {
+    pages[thread] = (page_id_t *)malloc(sizeof(page_id_t) * access_num);
+  }
+  page_id_t *working_set = (page_id_t *)malloc(sizeof(page_id_t) * frames_num);
+  bool *touched = (bool *)malloc(sizeof(bool) * frames_num);
+  bool exact = true;
+
+  for (size_t policy = 0; policy < POLICY_NUM; ++policy) {
+    if (POLICIES[policy].create_replacer_ == NULL) {
+      continue;
+    }
+    for (int thrash = 0; thrash < 2; ++thrash) {
+      ShardedBufferManager *manager =
+          ShardedBufferManagerInit(frames_num, shard_num, POLICIES[policy].create_replacer_);
+      // The pages that fit take up exactly the frames of their shard, so nothing is ever evicted
+      size_t *room = (size_t *)malloc(sizeof(size_t) * manager->shard_num_);
+      for (size_t shard = 0; shard < manager->shard_num_; ++shard) {
+        room[shard] = manager->shards_[shard].pool_size_;
+      }
+      for (size_t page_num = 0, page = 0; page_num < frames_num; ++page) {
+        const size_t shard = ShardedBufferManagerShardOf(manager, (page_id_t)page);
+        if (room[shard] > 0) {
+          room[shard]--;
+          working_set[page_num++] = (page_id_t)page;
+        }
+      }
+      free(room);
+
+      // Every thread draws its own pages, the pages that fit are counted to know the compulsory misses
+      size_t touched_num = 0;
+      for (size_t i = 0; i < frames_num; ++i) {
+        touched[i] = false;
+      }
+      for (size_t thread = 0; thread < thread_num; ++thread) {
+        crand_t rng = crand_init((uint64_t)seed + thread);
+        for (size_t i = 0; i < access_num; ++i) {
+          if (thrash) {
+            pages[thread][i] = (page_id_t)(crand_u64(&rng) % (4 * frames_num));
+          } else {
+            const size_t index = crand_u64(&rng) % frames_num;
+            touched_num += touched[index] ? 0 : 1;
+            touched[index] = true;
+            pages[thread][i] = working_set[index];
+          }
+        }
+      }
+
+      StressResult result;
+      if (!StressRun(manager, pages, access_num, thread_num, buffered_hits, &result)) {
+        exact = false;
+      }
+      const size_t miss_num = result.compulsory_miss_num_ + result.capacity_miss_num_;
+      bool phase_exact = result.bad_frame_num_ == 0 && result.hit_num_ + miss_num == result.access_num_;
+      if (thrash) {
+        phase_exact = phase_exact && result.compulsory_miss_num_ <= frames_num;
+      } else {
+        phase_exact = phase_exact && result.compulsory_miss_num_ == touched_num && result.capacity_miss_num_ == 0;
+      }
+      exact = exact && phase_exact;
+      printf("%s %s: %zu hits, %zu compulsory misses, %zu capacity misses in %zu accesses, %.2lf M accesses/s%s\n",
+             POLICIES[policy].name_, thrash ? "thrash" : "fit", result.hit_num_, result.compulsory_miss_num_,
+             result.capacity_miss_num_, result.access_num_, (double)result.access_num_ / result.seconds_ / 1e6,
+             phase_exact ? "" : ", MISMATCH");
+      ShardedBufferManagerDestroy(manager);
+    }
+  }
+
+  for (size_t thread = 0; thread < thread_num; ++thread) {
+    free(pages[thread]);
+  }
+  free(pages);
+  free(working_set);
+  free(touched);
+  return exact;
 }
@@ -0,0 +1,117 @@
+#include "memory/opt_simulator.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "memory/replacer.h"
+
+#define i_type OptPageIndex
+#define i_key page_id_t
+#define i_val size_t
+#include "stc/cmap.h"
+
+// Max-heap of the next uses of the resident pages
+#define i_type OptNextUseHeap
+#define i_key size_t
+#include "stc/cpque.h"
+
+#include "stc/cbits.h"
+
+//===----------------------------------------------------------------------===//
+// OPT Simulator Implementation
+//===----------------------------------------------------------------------===//
+void OptComputeNextUse(const page_id_t *trace, size_t access_num, size_t *next_use) {
+  if (access_num == 0) {
+    return;
+  }
+  page_id_t min_page = trace[0];
+  page_id_t max_page = trace[0];
+  for (size_t i = 1; i < access_num; ++i) {
+    min_page = trace[i] < min_page ? trace[i] : min_page;
+    max_page = trace[i] > max_page ? trace[i] : max_page;
+  }
+
+  // Walking backwards, the index last seen for a page is the next use of the access at hand
+  const size_t page_range = (size_t)((int64_t)max_page - min_page) + 1;
+  if (page_range <= 2 * access_num) {
+    // Page ids are dense enough to index an array directly
+    size_t *last_seen = (size_t *)malloc(sizeof(size_t) * page_range);
+    for (size_t page = 0; page < page_range; ++page) {
+      last_seen[page] = access_num;
+    }
+    for (size_t i = access_num; i-- > 0;) {
+      size_t *seen = &last_seen[(size_t)((int64_t)trace[i] - min_page)];
+      next_use[i] = *seen;
+      *seen = i;
+    }
+    free(last_seen);
+    return;
+  }
+
+  OptPageIndex last_seen = OptPageIndex_init();
+  for (size_t i = access_num; i-- > 0;) {
+    OptPageIndex_result seen = OptPageIndex_insert(&last_seen, trace[i], i);
+    if (seen.inserted) {
+      next_use[i] = access_num;
+    } else {
+      next_use[i] = seen.ref->second;
+      seen.ref->second = i;
+    }
+  }
+  OptPageIndex_drop(&last_seen);
+}
+
+void OptSimulate(const page_id_t *trace, size_t access_num, size_t pool_size, size_t *compulsory_miss_num,
+                 size_t *capacity_miss_num) {
+  *compulsory_miss_num = 0;
+  *capacity_miss_num = 0;
+  if (pool_size == 0) {
+    *compulsory_miss_num = access_num;
+    return;
+  }
+
+  size_t *next_use = (size_t *)malloc(sizeof(size_t) * access_num);
+  OptComputeNextUse(trace, access_num, next_use);
+
+  // A resident page is keyed by the index of its next access, so access i hits iff the key i is alive. A hit
+  // leaves its old key in the heap, which can't reach the top while the pool is full since it lies in the past.
+  cbits alive = cbits_with_size((intptr_t)access_num, false);
+  OptNextUseHeap heap = OptNextUseHeap_with_capacity((intptr_t)(2 * pool_size));
+  size_t resident_num = 0;
+
+  for (size_t i = 0; i < access_num; ++i) {
+    if (cbits_test(&alive, (intptr_t)i)) {
+      cbits_reset(&alive, (intptr_t)i);
+    } else if (resident_num < pool_size) {
+      resident_num++;
+      (*compulsory_miss_num)++;
+    } else {
+      // The top is the page used farthest in the future
+      const size_t victim_next_use = *OptNextUseHeap_top(&heap);
+      OptNextUseHeap_pop(&heap);
+      if (victim_next_use < access_num) {
+        cbits_reset(&alive, (intptr_t)victim_next_use);
+      }
+      (*capacity_miss_num)++;
+    }
+
+    if (next_use[i] < access_num) {
+      cbits_set(&alive, (intptr_t)next_use[i]);
+    }
+    if ((size_t)OptNextUseHeap_size(&heap) == 2 * pool_size) {
+      // Drop the keys left behind by hits, every key that is still ahead belongs to a resident page
+      intptr_t kept = 0;
+      for (intptr_t k = 0; k < heap._len; ++k) {
+        if (heap.data[k] > i) {
+          heap.data[kept++] = heap.data[k];
+        }
+      }
+      heap._len = kept;
+      OptNextUseHeap_make_heap(&heap);
+    }
+    OptNextUseHeap_push(&heap, next_use[i]);
+  }
+
+  OptNextUseHeap_drop(&heap);
+  cbits_drop(&alive);
+  free(next_use);
+}
@@ -0,0 +1,212 @@
+#define _POSIX_C_SOURCE 200809L
+#include "memory/page_store.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// Page Store Implementation
+//===----------------------------------------------------------------------===//
+static bool PageStoreWriteFile(PageStore *store, page_id_t page_id, const uint8_t *data) {
+  const off_t offset = (off_t)page_id * (off_t)store->page_size_;
+  size_t written = 0;
+  while (written < store->page_size_) {
+    const ssize_t result = pwrite(store->fd_, data + written, store->page_size_ - written, offset + (off_t)written);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      fprintf(stderr, "Can't write page %d to the page store\n", page_id);
+      return false;
+    }
+    written += (size_t)result;
+  }
+  return true;
+}
+
+static void *PageStoreWriterMain(void *arg) {
+  PageStoreWriter *writer = (PageStoreWriter *)arg;
+  const size_t page_size = writer->store_->page_size_;
+  pthread_mutex_lock(&writer->lock_);
+  for (;;) {
+    while (writer->size_ == 0 && !writer->stop_) {
+      pthread_cond_wait(&writer->not_empty_, &writer->lock_);
+    }
+    if (writer->size_ == 0) {
+      break;
+    }
+    // The front write stays in the queue while it is written, so reads of the page still find it
+    const page_id_t page_id = writer->page_ids_[writer->head_];
+    const uint8_t *data = writer->data_ + writer->head_ * page_size;
+    pthread_mutex_unlock(&writer->lock_);
+    const bool succeed = PageStoreWriteFile(writer->store_, page_id, data);
+    pthread_mutex_lock(&writer->lock_);
+    writer->failed_ = writer->failed_ || !succeed;
+    writer->head_ = (writer->head_ + 1) % PAGE_STORE_QUEUE_SIZE;
+    writer->size_--;
+    pthread_cond_signal(&writer->not_full_);
+    if (writer->size_ == 0) {
+      pthread_cond_broadcast(&writer->idle_);
+    }
+  }
+  pthread_mutex_unlock(&writer->lock_);
+  return NULL;
+}
+
+PageStore *PageStoreOpen(const char *path, size_t page_size, size_t writer_num) {
+  const int fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd == -1) {
+    fprintf(stderr, "Can't open page store %s\n", path);
+    return NULL;
+  }
+  if (writer_num == 0) {
+    writer_num = 1;
+  }
+
+  PageStore *store = (PageStore *)malloc(sizeof(PageStore));
+  store->fd_ = fd;
+  store->page_size_ = page_size;
+  store->writers_ = (PageStoreWriter *)malloc(sizeof(PageStoreWriter) * writer_num);
+  store->writer_num_ = 0;
+  for (size_t i = 0; i < writer_num; ++i) {
+    PageStoreWriter *writer = &store->writers_[i];
+    writer->store_ = store;
+    pthread_mutex_init(&writer->lock_, NULL);
+    pthread_cond_init(&writer->not_empty_, NULL);
+    pthread_cond_init(&writer->not_full_, NULL);
+    pthread_cond_init(&writer->idle_, NULL);
+    writer->data_ = (uint8_t *)malloc(PAGE_STORE_QUEUE_SIZE * page_size);
+    writer->head_ = 0;
+    writer->size_ = 0;
+    writer->failed_ = false;
+    writer->stop_ = false;
+    if (pthread_create(&writer->thread_, NULL, PageStoreWriterMain, writer) != 0) {
+      // The writers already started are enough
+      fprintf(stderr, "Can't start page store writer %zu\n", i);
+      pthread_mutex_destroy(&writer->lock_);
+      pthread_cond_destroy(&writer->not_empty_);
+      pthread_cond_destroy(&writer->not_full_);
+      pthread_cond_destroy(&writer->idle_);
+      free(writer->data_);
+      break;
+    }
+    store->writer_num_++;
+  }
+  if (store->writer_num_ == 0) {
+    close(fd);
+    free(store->writers_);
+    free(store);
+    return NULL;
+  }
+  return store;
+}
+
+void PageStoreClose(PageStore *store) {
+  for (size_t i = 0; i < store->writer_num_; ++i) {
+    PageStoreWriter *writer = &store->writers_[i];
+    pthread_mutex_lock(&writer->lock_);
+    writer->stop_ = true;
+    pthread_cond_signal(&writer->not_empty_);
+    pthread_mutex_unlock(&writer->lock_);
+    // The writer finishes its queue before it stops
+    pthread_join(writer->thread_, NULL);
+    pthread_mutex_destroy(&writer->lock_);
+    pthread_cond_destroy(&writer->not_empty_);
+    pthread_cond_destroy(&writer->not_full_);
+    pthread_cond_destroy(&writer->idle_);
+    free(writer->data_);
+  }
+  close(store->fd_);
+  free(store->writers_);
+  free(store);
+}
+
+static PageStoreWriter *PageStoreWriterOf(PageStore *store, page_id_t page_id) {
+  return &store->writers_[(uint32_t)page_id % store->writer_num_];
+}
+
+bool PageStoreRead(PageStore *store, page_id_t page_id, uint8_t *data) {
+  if (page_id < 0) {
+    fprintf(stderr, "Page %d can't be in the page store\n", page_id);
+    memset(data, 0, store->page_size_);
+    return false;
+  }
+  // A queued write is newer than the file, the newest one wins
+  PageStoreWriter *writer = PageStoreWriterOf(store, page_id);
+  pthread_mutex_lock(&writer->lock_);
+  for (size_t i = writer->size_; i > 0; --i) {
+    const size_t slot = (writer->head_ + i - 1) % PAGE_STORE_QUEUE_SIZE;
+    if (writer->page_ids_[slot] == page_id) {
+      memcpy(data, writer->data_ + slot * store->page_size_, store->page_size_);
+      pthread_mutex_unlock(&writer->lock_);
+      return true;
+    }
+  }
+  pthread_mutex_unlock(&writer->lock_);
+
+  // A write leaves the queue only once it is on the file, so the file is current here
+  const off_t offset = (off_t)page_id * (off_t)store->page_size_;
+  size_t read_size = 0;
+  while (read_size < store->page_size_) {
+    const ssize_t result =
+        pread(store->fd_, data + read_size, store->page_size_ - read_size, offset + (off_t)read_size);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result < 0) {
+      fprintf(stderr, "Can't read page %d from the page store\n", page_id);
+      memset(data, 0, store->page_size_);
+      return false;
+    }
+    if (result == 0) {
+      // Past the end of the file, the page was never written
+      memset(data + read_size, 0, store->page_size_ - read_size);
+      break;
+    }
+    read_size += (size_t)result;
+  }
+  return true;
+}
+
+bool PageStoreWriteAsync(PageStore *store, page_id_t page_id, const uint8_t *data) {
+  if (page_id < 0) {
+    fprintf(stderr, "Page %d can't be in the page store\n", page_id);
+    return false;
+  }
+  PageStoreWriter *writer = PageStoreWriterOf(store, page_id);
+  pthread_mutex_lock(&writer->lock_);
+  while (writer->size_ == PAGE_STORE_QUEUE_SIZE) {
+    pthread_cond_wait(&writer->not_full_, &writer->lock_);
+  }
+  const size_t slot = (writer->head_ + writer->size_) % PAGE_STORE_QUEUE_SIZE;
+  writer->page_ids_[slot] = page_id;
+  memcpy(writer->data_ + slot * store->page_size_, data, store->page_size_);
+  writer->size_++;
+  pthread_cond_signal(&writer->not_empty_);
+  pthread_mutex_unlock(&writer->lock_);
+  return true;
+}
+
+bool PageStoreSync(PageStore *store) {
+  bool succeed = true;
+  for (size_t i = 0; i < store->writer_num_; ++i) {
+    PageStoreWriter *writer = &store->writers_[i];
+    pthread_mutex_lock(&writer->lock_);
+    while (writer->size_ > 0) {
+      pthread_cond_wait(&writer->idle_, &writer->lock_);
+    }
+    succeed = succeed && !writer->failed_;
+    writer->failed_ = false;
+    pthread_mutex_unlock(&writer->lock_);
+  }
+  return succeed;
+}
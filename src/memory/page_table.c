@@ -0,0 +1,126 @@
+#include "memory/page_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// Page Table Implementation
+//===----------------------------------------------------------------------===//
+PageTable *PageTableInit(size_t capacity) {
+  // At most half of the slots are used, so probe runs stay short and always end at an empty slot
+  size_t slot_num = PAGE_TABLE_GROUP_WIDTH;
+  size_t shift = 64 - 4;
+  while (slot_num < 2 * capacity) {
+    slot_num <<= 1;
+    shift--;
+  }
+
+  PageTable *table = (PageTable *)malloc(sizeof(PageTable));
+  table->ctrl_ = (uint8_t *)aligned_alloc(PAGE_TABLE_GROUP_WIDTH, slot_num);
+  memset(table->ctrl_, PAGE_TABLE_EMPTY, slot_num);
+  table->slots_ = (PageTableSlot *)malloc(sizeof(PageTableSlot) * slot_num);
+  table->mask_ = slot_num - 1;
+  table->shift_ = shift;
+  table->size_ = 0;
+  table->capacity_ = capacity;
+  return table;
+}
+
+void PageTableDestroy(PageTable *table) {
+  free(table->ctrl_);
+  free(table->slots_);
+  free(table);
+}
+
+void PageTableInsert(PageTable *table, page_id_t page_id, frame_id_t frame_id) {
+  const uint64_t hash = PageTableHash(page_id);
+  const size_t home = PageTableHomeSlot(table, hash);
+  size_t pos = home & ~(size_t)(PAGE_TABLE_GROUP_WIDTH - 1);
+  uint32_t window = PAGE_TABLE_GROUP_BITS << (home & (PAGE_TABLE_GROUP_WIDTH - 1));
+  for (;;) {
+    const uint32_t empty = PageTableGroupMatch(table->ctrl_ + pos, PAGE_TABLE_EMPTY) & window;
+    if (empty != 0) {
+      PageTableInsertAt(table, pos + PageTableLowestBit(empty), page_id, frame_id);
+      return;
+    }
+    pos = (pos + PAGE_TABLE_GROUP_WIDTH) & table->mask_;
+    window = PAGE_TABLE_GROUP_BITS;
+  }
+}
+
+void PageTableInsertAt(PageTable *table, size_t empty_slot, page_id_t page_id, frame_id_t frame_id) {
+  PAGE_TABLE_STORE(table->slots_[empty_slot].page_id_, page_id);
+  PAGE_TABLE_STORE(table->slots_[empty_slot].frame_id_, frame_id);
+  PAGE_TABLE_STORE(table->ctrl_[empty_slot], PageTableControlByte(PageTableHash(page_id)));
+  table->size_++;
+}
+
+// Empty a slot, then shift back every following page of the run that may live closer to its home slot
+static void PageTableEraseSlot(PageTable *table, size_t hole) {
+  for (size_t slot = (hole + 1) & table->mask_; table->ctrl_[slot] != PAGE_TABLE_EMPTY;
+       slot = (slot + 1) & table->mask_) {
+    const size_t home = PageTableHomeSlot(table, PageTableHash(table->slots_[slot].page_id_));
+    // The page can fill the hole if the hole isn't before its home slot on the run
+    if (((slot - home) & table->mask_) >= ((slot - hole) & table->mask_)) {
+      PAGE_TABLE_STORE(table->slots_[hole].page_id_, table->slots_[slot].page_id_);
+      PAGE_TABLE_STORE(table->slots_[hole].frame_id_, table->slots_[slot].frame_id_);
+      PAGE_TABLE_STORE(table->ctrl_[hole], table->ctrl_[slot]);
+      hole = slot;
+    }
+  }
+  PAGE_TABLE_STORE(table->ctrl_[hole], (uint8_t)PAGE_TABLE_EMPTY);
+  table->size_--;
+}
+
+bool PageTableErase(PageTable *table, page_id_t page_id) {
+  const ptrdiff_t slot = PageTableFindSlot(table, page_id);
+  if (slot == -1) {
+    return false;
+  }
+  PageTableEraseSlot(table, (size_t)slot);
+  return true;
+}
+
+void PageTableReplace(PageTable *table, page_id_t old_page_id, page_id_t new_page_id, frame_id_t frame_id,
+                      size_t empty_slot) {
+  const ptrdiff_t slot = PageTableFindSlot(table, old_page_id);
+  const uint64_t hash = PageTableHash(new_page_id);
+  const size_t home = PageTableHomeSlot(table, hash);
+  // A lookup of the new page walks from its home slot to empty_slot, so the old slot can be taken over in place when
+  // it lies before empty_slot on that walk
+  if ((((size_t)slot - home) & table->mask_) < ((empty_slot - home) & table->mask_)) {
+    PAGE_TABLE_STORE(table->slots_[slot].page_id_, new_page_id);
+    PAGE_TABLE_STORE(table->slots_[slot].frame_id_, frame_id);
+    PAGE_TABLE_STORE(table->ctrl_[slot], PageTableControlByte(hash));
+    return;
+  }
+  // Erasing may empty a slot before empty_slot on the run of the new page, so the insert probes again
+  PageTableEraseSlot(table, (size_t)slot);
+  PageTableInsert(table, new_page_id, frame_id);
+}
+
+size_t PageTableSize(const PageTable *table) { return table->size_; }
+
+void PageTableProbeStats(const PageTable *table, double *mean_probe_len, size_t *max_probe_len) {
+  size_t total_probe_len = 0;
+  *max_probe_len = 0;
+  for (size_t slot = 0; slot <= table->mask_; ++slot) {
+    if (table->ctrl_[slot] == PAGE_TABLE_EMPTY) {
+      continue;
+    }
+    const size_t home = PageTableHomeSlot(table, PageTableHash(table->slots_[slot].page_id_));
+    const size_t probe_len = ((slot - home) & table->mask_) + 1;
+    total_probe_len += probe_len;
+    if (probe_len > *max_probe_len) {
+      *max_probe_len = probe_len;
+    }
+  }
+  *mean_probe_len = table->size_ > 0 ? (double)total_probe_len / (double)table->size_ : 0.0;
+}
+
+size_t PageTableMemoryUsage(const PageTable *table) {
+  return sizeof(PageTable) + (table->mask_ + 1) * (sizeof(uint8_t) + sizeof(PageTableSlot));
+}
@@ -0,0 +1,191 @@
+#define _POSIX_C_SOURCE 200809L
+#include "memory/page_trace.h"
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// Page Trace Implementation
+//===----------------------------------------------------------------------===//
+static const char PAGE_TRACE_MAGIC[8] = {'P', 'G', 'T', 'R', 'A', 'C', 'E', '\0'};
+
+static void PageTraceEncodeHeader(uint8_t *header, uint64_t access_num) {
+  memcpy(header, PAGE_TRACE_MAGIC, sizeof(PAGE_TRACE_MAGIC));
+  for (int i = 0; i < 4; ++i) {
+    header[8 + i] = (uint8_t)(PAGE_TRACE_VERSION >> (8 * i));
+    header[12 + i] = 0;
+  }
+  for (int i = 0; i < 8; ++i) {
+    header[16 + i] = (uint8_t)(access_num >> (8 * i));
+  }
+}
+
+PageTraceWriter *PageTraceWriterOpen(const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    fprintf(stderr, "Can't create trace file %s\n", path);
+    return NULL;
+  }
+  // The number of accesses is only known on close, a placeholder header is written for now
+  uint8_t header[PAGE_TRACE_HEADER_SIZE];
+  PageTraceEncodeHeader(header, 0);
+  if (fwrite(header, 1, sizeof(header), file) != sizeof(header)) {
+    fprintf(stderr, "Can't write trace file %s\n", path);
+    fclose(file);
+    return NULL;
+  }
+
+  PageTraceWriter *writer = (PageTraceWriter *)malloc(sizeof(PageTraceWriter));
+  writer->file_ = file;
+  writer->access_num_ = 0;
+  writer->last_page_ = 0;
+  return writer;
+}
+
+bool PageTraceWriterAppend(PageTraceWriter *writer, page_id_t page_id) {
+  const int64_t delta = (int64_t)page_id - writer->last_page_;
+  uint64_t zigzag = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+  uint8_t varint[10];
+  size_t length = 0;
+  while (zigzag >= 0x80) {
+    varint[length++] = (uint8_t)(zigzag | 0x80);
+    zigzag >>= 7;
+  }
+  varint[length++] = (uint8_t)zigzag;
+
+  if (fwrite(varint, 1, length, writer->file_) != length) {
+    return false;
+  }
+  writer->last_page_ = page_id;
+  writer->access_num_++;
+  return true;
+}
+
+bool PageTraceWriterClose(PageTraceWriter *writer) {
+  uint8_t header[PAGE_TRACE_HEADER_SIZE];
+  PageTraceEncodeHeader(header, writer->access_num_);
+  bool succeed =
+      fseek(writer->file_, 0, SEEK_SET) == 0 && fwrite(header, 1, sizeof(header), writer->file_) == sizeof(header);
+  succeed = fclose(writer->file_) == 0 && succeed;
+  if (!succeed) {
+    fprintf(stderr, "Can't finish the trace file\n");
+  }
+  free(writer);
+  return succeed;
+}
+
+// Decode the varint at *offset, false if it runs past the end of the file
+static bool PageTraceDecodeVarint(const uint8_t *data, size_t file_size, size_t *offset, uint64_t *value) {
+  uint64_t result = 0;
+  for (unsigned shift = 0; shift < 64 && *offset < file_size; shift += 7) {
+    const uint8_t byte = data[(*offset)++];
+    result |= (uint64_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+PageTraceReader *PageTraceReaderOpen(const char *path) {
+  const int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    fprintf(stderr, "Can't open trace file %s\n", path);
+    return NULL;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1 || (size_t)file_stat.st_size < PAGE_TRACE_HEADER_SIZE) {
+    fprintf(stderr, "%s is not a page trace\n", path);
+    close(fd);
+    return NULL;
+  }
+  const size_t file_size = (size_t)file_stat.st_size;
+  void *data = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file alive
+  close(fd);
+  if (data == MAP_FAILED) {
+    fprintf(stderr, "Can't map trace file %s\n", path);
+    return NULL;
+  }
+  posix_madvise(data, file_size, POSIX_MADV_SEQUENTIAL);
+
+  const uint8_t *header = (const uint8_t *)data;
+  uint32_t version = 0;
+  uint64_t access_num = 0;
+  for (int i = 0; i < 4; ++i) {
+    version |= (uint32_t)header[8 + i] << (8 * i);
+  }
+  for (int i = 0; i < 8; ++i) {
+    access_num |= (uint64_t)header[16 + i] << (8 * i);
+  }
+  if (memcmp(header, PAGE_TRACE_MAGIC, sizeof(PAGE_TRACE_MAGIC)) != 0 || version != PAGE_TRACE_VERSION) {
+    fprintf(stderr, "%s is not a page trace of version %d\n", path, PAGE_TRACE_VERSION);
+    munmap(data, file_size);
+    return NULL;
+  }
+  // A truncated trace is rejected up front, every replay then decodes exactly the accesses the header announces
+  size_t offset = PAGE_TRACE_HEADER_SIZE;
+  for (uint64_t i = 0; i < access_num; ++i) {
+    uint64_t zigzag;
+    if (!PageTraceDecodeVarint(header, file_size, &offset, &zigzag)) {
+      fprintf(stderr, "%s is truncated after %llu of %llu accesses\n", path, (unsigned long long)i,
+              (unsigned long long)access_num);
+      munmap(data, file_size);
+      return NULL;
+    }
+  }
+
+  PageTraceReader *reader = (PageTraceReader *)malloc(sizeof(PageTraceReader));
+  reader->data_ = header;
+  reader->file_size_ = file_size;
+  reader->access_num_ = (size_t)access_num;
+  PageTraceReaderRewind(reader);
+  return reader;
+}
+
+void PageTraceReaderClose(PageTraceReader *reader) {
+  munmap((void *)reader->data_, reader->file_size_);
+  free(reader);
+}
+
+size_t PageTraceReaderRead(PageTraceReader *reader, page_id_t *page_ids, size_t n) {
+  if (n > reader->access_num_ - reader->read_num_) {
+    n = reader->access_num_ - reader->read_num_;
+  }
+
+  size_t offset = reader->offset_;
+  page_id_t page = reader->last_page_;
+  size_t decoded = 0;
+  for (; decoded < n; ++decoded) {
+    uint64_t zigzag;
+    if (!PageTraceDecodeVarint(reader->data_, reader->file_size_, &offset, &zigzag)) {
+      // Unreachable, PageTraceReaderOpen checked that every access decodes
+      break;
+    }
+    const int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+    page = (page_id_t)((int64_t)page + delta);
+    page_ids[decoded] = page;
+  }
+
+  reader->offset_ = offset;
+  reader->last_page_ = page;
+  reader->read_num_ += decoded;
+  return decoded;
+}
+
+void PageTraceReaderRewind(PageTraceReader *reader) {
+  reader->offset_ = PAGE_TRACE_HEADER_SIZE;
+  reader->read_num_ = 0;
+  reader->last_page_ = 0;
+}
+
+size_t PageTraceReaderSize(const PageTraceReader *reader) { return reader->access_num_; }
@@ -0,0 +1,92 @@
+#include "memory/prefetcher.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// Prefetcher Implementation
+//===----------------------------------------------------------------------===//
+Prefetcher *PrefetcherInit(size_t stream_num, size_t degree) {
+  if (stream_num == 0) {
+    stream_num = 1;
+  }
+  Prefetcher *prefetcher = (Prefetcher *)malloc(sizeof(Prefetcher));
+  prefetcher->streams_ = (PrefetchStream *)calloc(stream_num, sizeof(PrefetchStream));
+  prefetcher->stream_num_ = stream_num;
+  prefetcher->degree_ = degree;
+  prefetcher->clock_ = 0;
+  return prefetcher;
+}
+
+void PrefetcherDestroy(Prefetcher *prefetcher) {
+  free(prefetcher->streams_);
+  free(prefetcher);
+}
+
+// The stream an access continues, or the stream to replace with a new one
+static PrefetchStream *PrefetcherFindStream(Prefetcher *prefetcher, uint32_t requester, page_id_t page_id) {
+  PrefetchStream *victim = &prefetcher->streams_[0];
+  for (size_t i = 0; i < prefetcher->stream_num_; ++i) {
+    PrefetchStream *stream = &prefetcher->streams_[i];
+    if (!stream->valid_) {
+      victim = stream;
+      continue;
+    }
+    const int64_t distance = (int64_t)page_id - stream->last_page_;
+    if (stream->requester_ == requester && distance >= -PREFETCH_STREAM_WINDOW && distance <= PREFETCH_STREAM_WINDOW) {
+      return stream;
+    }
+    if (victim->valid_ && stream->last_use_ < victim->last_use_) {
+      victim = stream;
+    }
+  }
+  victim->valid_ = false;
+  return victim;
+}
+
+size_t PrefetcherObserve(Prefetcher *prefetcher, uint32_t requester, page_id_t page_id, page_id_t *prefetch_pages) {
+  PrefetchStream *stream = PrefetcherFindStream(prefetcher, requester, page_id);
+  stream->last_use_ = ++prefetcher->clock_;
+  if (!stream->valid_) {
+    stream->valid_ = true;
+    stream->requester_ = requester;
+    stream->last_page_ = page_id;
+    stream->stride_ = 0;
+    stream->confidence_ = 0;
+    return 0;
+  }
+
+  const int64_t stride = (int64_t)page_id - stream->last_page_;
+  if (stride == 0) {
+    return 0;
+  }
+  stream->last_page_ = page_id;
+  if (stride != stream->stride_) {
+    stream->stride_ = stride;
+    stream->confidence_ = 1;
+    return 0;
+  }
+  if (++stream->confidence_ < PREFETCH_CONFIDENCE) {
+    return 0;
+  }
+
+  // Ask for the pages up to degree strides ahead that weren't asked for yet
+  int64_t next = (int64_t)page_id + stride;
+  if (stream->confidence_ > PREFETCH_CONFIDENCE) {
+    const int64_t after_prefetched = stream->prefetched_to_ + stride;
+    if (stride > 0 ? after_prefetched > next : after_prefetched < next) {
+      next = after_prefetched;
+    }
+  }
+  const int64_t last = (int64_t)page_id + stride * (int64_t)prefetcher->degree_;
+  size_t prefetch_num = 0;
+  for (; stride > 0 ? next <= last : next >= last; next += stride) {
+    if (next >= 0 && next <= INT32_MAX) {
+      prefetch_pages[prefetch_num++] = (page_id_t)next;
+    }
+  }
+  stream->prefetched_to_ = last;
+  return prefetch_num;
+}
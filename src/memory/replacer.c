@@ -1,21 +1,28 @@
 #include "memory/replacer.h"
-#include <limits.h>
 #include <stddef.h>
 #include <stdio.h>
 
 //===----------------------------------------------------------------------===//
 // Frame Implementation
 //===----------------------------------------------------------------------===//
-Frame FrameInit(size_t k, frame_id_t fid) {
+Frame FrameInit(size_t k, frame_id_t fid, size_t *history) {
   Frame node;
-  node.history_ = UIList_init();
+  node.history_ = history;
   node.k_ = k;
   node.fid_ = fid;
-  node.is_evictable_ = false;
+  FrameReset(&node);
   return node;
 }
 
-void FrameDestroy(Frame *node) { UIList_drop(&node->history_); }
+void FrameReset(Frame *node) {
+  node->next_slot_ = 0;
+  node->access_num_ = 0;
+  node->oldest_timestamp_ = 0;
+  node->prev_ = -1;
+  node->next_ = -1;
+  node->is_present_ = false;
+  node->is_evictable_ = false;
+}
 
 // Check whether a frame is evictable
 bool IsEvictable(Frame *node) { return node->is_evictable_; }
@@ -24,42 +31,47 @@ bool IsEvictable(Frame *node) { return node->is_evictable_; }
 void SetEvictable(Frame *node, bool set_evictable) { node->is_evictable_ = set_evictable; }
 
 void FrameAccessed(Frame *node, size_t timestamp) {
-  // New timestamp is added to the front of the timestamp list
-  UIList_push_front(&node->history_, timestamp);
+  if (node->access_num_ == 0) {
+    node->oldest_timestamp_ = timestamp;
+  }
+  node->access_num_++;
+  if (node->k_ == 0) {
+    return;
+  }
+  // New timestamp overwrites the slot of the k-th most recent access
+  node->history_[node->next_slot_] = timestamp;
+  node->next_slot_ = node->next_slot_ + 1 == node->k_ ? 0 : node->next_slot_ + 1;
 }
 
 size_t TimestampNum(Frame *node) {
   // Return the number of timestamps
-  return UIList_count(&node->history_);
+  return node->access_num_;
 }
 
 size_t OldestTimestamp(Frame *node) {
   // Return the oldest timestamp
-  return *UIList_back(&node->history_);
+  return node->oldest_timestamp_;
 }
 
 frame_id_t GetFrameId(Frame *node) { return node->fid_; }
 
-// Get the kth timestamp
+// Get the kth timestamp, only valid when the frame has been accessed at least k times
 size_t KthTimestamp(Frame *node) {
-  UIList_iter iter = UIList_begin(&node->history_);
-  iter = UIList_advance(iter, node->k_ - 1);
-  return *iter.ref;
+  // Once the buffer is full, the next slot to be overwritten holds the k-th most recent access
+  return node->history_[node->next_slot_];
 }
 
-Frame Frame_clone(Frame node) {
-  node.history_ = UIList_clone(node.history_);
-  node.fid_ = node.fid_;
-  node.k_ = node.k_;
-  node.is_evictable_ = node.is_evictable_;
-  return node;
-}
 //===----------------------------------------------------------------------===//
 // Replacer Implementation
 //===----------------------------------------------------------------------===//
 Replacer *ReplacerInit(size_t num_frames, size_t k) {
   Replacer *replacer = (Replacer *)malloc(sizeof(Replacer));
-  replacer->node_store_ = FrameTable_init();
+  replacer->node_store_ = (Frame *)malloc(sizeof(Frame) * num_frames);
+  replacer->history_store_ = (size_t *)malloc(sizeof(size_t) * num_frames * k);
+  for (size_t i = 0; i < num_frames; ++i) {
+    replacer->node_store_[i] = FrameInit(k, (frame_id_t)i, replacer->history_store_ + i * k);
+  }
+  replacer->evict_index_ = EvictIndex_with_capacity((intptr_t)num_frames);
   replacer->current_timestamp_ = 0;
   replacer->curr_size_ = 0;
   replacer->replacer_size_ = num_frames;
@@ -68,75 +80,70 @@ Replacer *ReplacerInit(size_t num_frames, size_t k) {
 }
 
 void ReplacerDestroy(Replacer *replacer) {
-  FrameTable_drop(&replacer->node_store_);
+  free(replacer->node_store_);
+  free(replacer->history_store_);
+  EvictIndex_drop(&replacer->evict_index_);
   free(replacer);
 }
 
+// Build the eviction index key of a frame from its current access history
+static EvictKey FrameEvictKey(Frame *node, size_t k) {
+  EvictKey key;
+  key.has_k_history_ = TimestampNum(node) >= k;
+  // If frame access is less than k, k-distance is +inf and only the oldest timestamp matters
+  key.kth_timestamp_ = key.has_k_history_ ? KthTimestamp(node) : 0;
+  key.oldest_timestamp_ = OldestTimestamp(node);
+  key.fid_ = GetFrameId(node);
+  return key;
+}
+
 bool ReplacerEvict(Replacer *replacer, frame_id_t *frame_id) {
   // If no frame is evictable, return false directly
   if (replacer->curr_size_ == 0) {
     return false;
   }
 
-  frame_id_t evict_frame_id;
-  size_t k_distance = 0;
-  size_t oldest_recent_timestamp = UINT_MAX;
-
-  c_forpair(frame_id, frame, FrameTable, replacer->node_store_) {
-    // Check whether the frame is evictable
-    if (IsEvictable(_.frame)) {
-      // If frame access is less than k-distance, k-distance is +inf
-      if (TimestampNum(_.frame) < replacer->k_) {
-        k_distance = UINT_MAX;
-        if (OldestTimestamp(_.frame) < oldest_recent_timestamp) {
-          // If the k-distance are equal, choose the earliest frame had been accessed
-          oldest_recent_timestamp = OldestTimestamp(_.frame);
-          evict_frame_id = *_.frame_id;
-        }
-      } else {
-        // Calculate the k-distance, find the maximum
-        if (replacer->current_timestamp_ - KthTimestamp(_.frame) > k_distance) {
-          k_distance = replacer->current_timestamp_ - KthTimestamp(_.frame);
-          evict_frame_id = *_.frame_id;
-        } else if (replacer->current_timestamp_ - KthTimestamp(_.frame) == k_distance) {
-          // If the k-distance are equal, choose the earliest frame had been accessed
-          if (OldestTimestamp(_.frame) < oldest_recent_timestamp) {
-            oldest_recent_timestamp = OldestTimestamp(_.frame);
-            evict_frame_id = *_.frame_id;
-          }
-        }
-      }
-    }
-  }
-
-  *frame_id = evict_frame_id;
-  FrameTable_erase(&replacer->node_store_, evict_frame_id);
+  // The front of the index has the largest backward k-distance, ties broken by the oldest access
+  const EvictKey victim = *EvictIndex_front(&replacer->evict_index_);
+  EvictIndex_erase(&replacer->evict_index_, victim);
+
+  *frame_id = victim.fid_;
+  FrameReset(&replacer->node_store_[victim.fid_]);
   replacer->curr_size_--;
   return true;
 }
 
 void ReplacerRecordAccess(Replacer *replacer, frame_id_t frame_id) {
   // Frame id is invalid
-  if ((size_t)frame_id > replacer->replacer_size_) {
+  if ((size_t)frame_id >= replacer->replacer_size_) {
     fprintf(stderr, "frame_id should be less than replacer_size\n");
+    return;
   }
 
-  // If the frame has not been seen before, insert it
-  Frame temp = FrameInit(replacer->k_, frame_id);
-  FrameTable_insert(&replacer->node_store_, frame_id, temp);
-  Frame *frame_ptr = FrameTable_at_mut(&replacer->node_store_, frame_id);
+  // If the frame has not been seen before, start tracking it
+  Frame *frame_ptr = &replacer->node_store_[frame_id];
+  frame_ptr->is_present_ = true;
+
+  // An evictable frame changes its position in the index after the access
+  const bool evictable = IsEvictable(frame_ptr);
+  if (evictable) {
+    EvictIndex_erase(&replacer->evict_index_, FrameEvictKey(frame_ptr, replacer->k_));
+  }
   FrameAccessed(frame_ptr, replacer->current_timestamp_);
+  if (evictable) {
+    EvictIndex_insert(&replacer->evict_index_, FrameEvictKey(frame_ptr, replacer->k_));
+  }
   replacer->current_timestamp_++;
 }
 
 void ReplacerSetEvictable(Replacer *replacer, frame_id_t frame_id, bool set_evictable) {
   // If the frame doesn't exist, directly return
-  if (!FrameTable_contains(&replacer->node_store_, frame_id)) {
+  if ((size_t)frame_id >= replacer->replacer_size_ || !replacer->node_store_[frame_id].is_present_) {
     fprintf(stderr, "Frame %d doesn't exist\n", frame_id);
     return;
   }
 
-  Frame *frame_ptr = FrameTable_at_mut(&replacer->node_store_, frame_id);
+  Frame *frame_ptr = &replacer->node_store_[frame_id];
 
   bool original_evictable = IsEvictable(frame_ptr);
   // If the evictable field of the given frame has not changed, return directly
@@ -147,21 +154,46 @@ void ReplacerSetEvictable(Replacer *replacer, frame_id_t frame_id, bool set_evic
   // A frame was previously non-evictable and is to be set to evictable
   if (!original_evictable) {
     SetEvictable(frame_ptr, set_evictable);
+    EvictIndex_insert(&replacer->evict_index_, FrameEvictKey(frame_ptr, replacer->k_));
     replacer->curr_size_++;
   } else {
     // A frame was previously evictable and is to be set to non-evictable
     SetEvictable(frame_ptr, set_evictable);
+    EvictIndex_erase(&replacer->evict_index_, FrameEvictKey(frame_ptr, replacer->k_));
     replacer->curr_size_--;
   }
 }
 
+void ReplacerAdmit(Replacer *replacer, frame_id_t frame_id, page_id_t page_id) {
+  (void)page_id;
+  ReplacerRecordAccess(replacer, frame_id);
+}
+
+void ReplacerRecordHits(Replacer *replacer, const frame_id_t *frame_ids, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    ReplacerRecordAccess(replacer, frame_ids[i]);
+    ReplacerSetEvictable(replacer, frame_ids[i], true);
+  }
+}
+
 size_t ReplacerSize(Replacer *replacer) { return replacer->curr_size_; }
+
+size_t ReplacerMemoryUsage(Replacer *replacer) {
+  const size_t frame_size = sizeof(Frame) + sizeof(size_t) * replacer->k_;
+  const size_t index_size = (size_t)(EvictIndex_capacity(&replacer->evict_index_) + 1) * sizeof(EvictIndex_node);
+  return sizeof(Replacer) + replacer->replacer_size_ * frame_size + index_size;
+}
 //===----------------------------------------------------------------------===//
 // FIFO Replacer implementation
 //===----------------------------------------------------------------------===//
 FIFOReplacer *FIFOReplacerInit(size_t num_frames) {
   FIFOReplacer *replacer = (FIFOReplacer *)malloc(sizeof(FIFOReplacer));
-  replacer->node_store_ = FrameTable_init();
+  replacer->node_store_ = (Frame *)malloc(sizeof(Frame) * num_frames);
+  for (size_t i = 0; i < num_frames; ++i) {
+    replacer->node_store_[i] = FrameInit(0, (frame_id_t)i, NULL);
+  }
+  replacer->head_ = -1;
+  replacer->tail_ = -1;
   replacer->current_timestamp_ = 0;
   replacer->curr_size_ = 0;
   replacer->replacer_size_ = num_frames;
@@ -169,58 +201,83 @@ FIFOReplacer *FIFOReplacerInit(size_t num_frames) {
 }
 
 void FIFOReplacerDestroy(FIFOReplacer *replacer) {
-  FrameTable_drop(&replacer->node_store_);
+  free(replacer->node_store_);
   free(replacer);
 }
 
+// Append a frame to the queue on its first access, so the queue is in order of first access
+static void FIFOQueueAppend(FIFOReplacer *replacer, Frame *node) {
+  node->prev_ = replacer->tail_;
+  node->next_ = -1;
+  if (replacer->tail_ == -1) {
+    replacer->head_ = node->fid_;
+  } else {
+    replacer->node_store_[replacer->tail_].next_ = node->fid_;
+  }
+  replacer->tail_ = node->fid_;
+}
+
+// Unlink a frame from the queue
+static void FIFOQueueUnlink(FIFOReplacer *replacer, Frame *node) {
+  Frame *frames = replacer->node_store_;
+  if (node->prev_ == -1) {
+    replacer->head_ = node->next_;
+  } else {
+    frames[node->prev_].next_ = node->next_;
+  }
+  if (node->next_ == -1) {
+    replacer->tail_ = node->prev_;
+  } else {
+    frames[node->next_].prev_ = node->prev_;
+  }
+  node->prev_ = -1;
+  node->next_ = -1;
+}
+
 bool FIFOReplacerEvict(FIFOReplacer *replacer, frame_id_t *frame_id) {
   // If no frame is evictable, return false directly
   if (replacer->curr_size_ == 0) {
     return false;
   }
 
-  frame_id_t evict_frame_id;
-  size_t oldest_recent_timestamp = UINT_MAX;
-
-  c_forpair(frame_id, frame, FrameTable, replacer->node_store_) {
-    // Check whether the frame is evictable
-    if (IsEvictable(_.frame)) {
-      // Choose the earliest frame had been accessed
-      if (OldestTimestamp(_.frame) < oldest_recent_timestamp) {
-        oldest_recent_timestamp = OldestTimestamp(_.frame);
-        evict_frame_id = *_.frame_id;
-      }
-    }
+  // The victim is the evictable frame with the earliest first access, pinned frames keep their place and are skipped
+  Frame *victim = &replacer->node_store_[replacer->head_];
+  while (!IsEvictable(victim)) {
+    victim = &replacer->node_store_[victim->next_];
   }
+  FIFOQueueUnlink(replacer, victim);
 
-  *frame_id = evict_frame_id;
-  FrameTable_erase(&replacer->node_store_, evict_frame_id);
+  *frame_id = GetFrameId(victim);
+  FrameReset(victim);
   replacer->curr_size_--;
   return true;
 }
 
 void FIFOReplacerRecordAccess(FIFOReplacer *replacer, frame_id_t frame_id) {
   // Frame id is invalid
-  if ((size_t)frame_id > replacer->replacer_size_) {
+  if ((size_t)frame_id >= replacer->replacer_size_) {
     fprintf(stderr, "frame_id should be less than replacer_size\n");
+    return;
   }
 
-  // If the frame has not been seen before, insert it
-  Frame temp = FrameInit(0, frame_id);
-  FrameTable_insert(&replacer->node_store_, frame_id, temp);
-  Frame *frame_ptr = FrameTable_at_mut(&replacer->node_store_, frame_id);
+  // If the frame has not been seen before, start tracking it
+  Frame *frame_ptr = &replacer->node_store_[frame_id];
+  if (!frame_ptr->is_present_) {
+    frame_ptr->is_present_ = true;
+    FIFOQueueAppend(replacer, frame_ptr);
+  }
   FrameAccessed(frame_ptr, replacer->current_timestamp_);
   replacer->current_timestamp_++;
 }
 
 void FIFOReplacerSetEvictable(FIFOReplacer *replacer, frame_id_t frame_id, bool set_evictable) {
   // If the frame doesn't exist, directly return
-  if (!FrameTable_contains(&replacer->node_store_, frame_id)) {
+  if ((size_t)frame_id >= replacer->replacer_size_ || !replacer->node_store_[frame_id].is_present_) {
     fprintf(stderr, "Frame %d doesn't exist\n", frame_id);
     return;
   }
 
-  Frame *frame_ptr = FrameTable_at_mut(&replacer->node_store_, frame_id);
+  Frame *frame_ptr = &replacer->node_store_[frame_id];
 
   bool original_evictable = IsEvictable(frame_ptr);
   // If the evictable field of the given frame has not changed, return directly
@@ -228,15 +285,81 @@ void FIFOReplacerSetEvictable(FIFOReplacer *replacer, frame_id_t frame_id, bool
     return;
   }
 
-  // A frame was previously non-evictable and is to be set to evictable
-  if (!original_evictable) {
-    SetEvictable(frame_ptr, set_evictable);
+  // The frame stays in the queue either way, so pinning and unpinning don't lose its place
+  SetEvictable(frame_ptr, set_evictable);
+  if (set_evictable) {
     replacer->curr_size_++;
   } else {
-    // A frame was previously evictable and is to be set to non-evictable
-    SetEvictable(frame_ptr, set_evictable);
     replacer->curr_size_--;
   }
 }
 
+void FIFOReplacerAdmit(FIFOReplacer *replacer, frame_id_t frame_id, page_id_t page_id) {
+  (void)page_id;
+  FIFOReplacerRecordAccess(replacer, frame_id);
+}
+
+void FIFOReplacerRecordHits(FIFOReplacer *replacer, const frame_id_t *frame_ids, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    FIFOReplacerRecordAccess(replacer, frame_ids[i]);
+    FIFOReplacerSetEvictable(replacer, frame_ids[i], true);
+  }
+}
+
 size_t FIFOReplacerSize(FIFOReplacer *replacer) { return replacer->curr_size_; }
+
+size_t FIFOReplacerMemoryUsage(FIFOReplacer *replacer) {
+  return sizeof(FIFOReplacer) + replacer->replacer_size_ * sizeof(Frame);
+}
+//===----------------------------------------------------------------------===//
+// Replacer interface implementation
+//===----------------------------------------------------------------------===//
+static bool LRUKEvict(void *replacer, frame_id_t *frame_id) { return ReplacerEvict(replacer, frame_id); }
+
+static void LRUKRecordAccess(void *replacer, frame_id_t frame_id) { ReplacerRecordAccess(replacer, frame_id); }
+
+static void LRUKSetEvictable(void *replacer, frame_id_t frame_id, bool set_evictable) {
+  ReplacerSetEvictable(replacer, frame_id, set_evictable);
+}
+
+static void LRUKRecordHits(void *replacer, const frame_id_t *frame_ids, size_t n) {
+  ReplacerRecordHits(replacer, frame_ids, n);
+}
+
+static void LRUKAdmit(void *replacer, frame_id_t frame_id, page_id_t page_id) {
+  ReplacerAdmit(replacer, frame_id, page_id);
+}
+
+static size_t LRUKSize(void *replacer) { return ReplacerSize(replacer); }
+
+static size_t LRUKMemoryUsage(void *replacer) { return ReplacerMemoryUsage(replacer); }
+
+static void LRUKDestroy(void *replacer) { ReplacerDestroy(replacer); }
+
+const ReplacerVTable LRUKReplacerVTable = {LRUKEvict, LRUKRecordAccess, LRUKRecordHits, LRUKSetEvictable, LRUKAdmit,
+                                           LRUKSize,  LRUKMemoryUsage,  LRUKDestroy};
+
+static bool FIFOEvict(void *replacer, frame_id_t *frame_id) { return FIFOReplacerEvict(replacer, frame_id); }
+
+static void FIFORecordAccess(void *replacer, frame_id_t frame_id) { FIFOReplacerRecordAccess(replacer, frame_id); }
+
+static void FIFOSetEvictable(void *replacer, frame_id_t frame_id, bool set_evictable) {
+  FIFOReplacerSetEvictable(replacer, frame_id, set_evictable);
+}
+
+static void FIFORecordHits(void *replacer, const frame_id_t *frame_ids, size_t n) {
+  FIFOReplacerRecordHits(replacer, frame_ids, n);
+}
+
+static void FIFOAdmit(void *replacer, frame_id_t frame_id, page_id_t page_id) {
+  FIFOReplacerAdmit(replacer, frame_id, page_id);
+}
+
+static size_t FIFOSize(void *replacer) { return FIFOReplacerSize(replacer); }
+
+static size_t FIFOMemoryUsage(void *replacer) { return FIFOReplacerMemoryUsage(replacer); }
+
+static void FIFODestroy(void *replacer) { FIFOReplacerDestroy(replacer); }
+
+const ReplacerVTable FIFOReplacerVTable = {FIFOEvict, FIFORecordAccess, FIFORecordHits, FIFOSetEvictable, FIFOAdmit,
+                                           FIFOSize,  FIFOMemoryUsage,  FIFODestroy};
@@ -0,0 +1,196 @@
+#include "memory/sharded_buffer_manager.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "memory/buffer_manager.h"
+#include "memory/page_table.h"
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// ShardedBufferManager Implementation
+//===----------------------------------------------------------------------===//
+ShardedBufferManager *ShardedBufferManagerInit(size_t pool_size, size_t shard_num,
+                                               AnyReplacer (*create_replacer)(size_t frames_num)) {
+  // Every shard needs a frame
+  if (shard_num > pool_size) {
+    shard_num = pool_size;
+  }
+  if (shard_num == 0) {
+    shard_num = 1;
+  }
+
+  ShardedBufferManager *manager = (ShardedBufferManager *)malloc(sizeof(ShardedBufferManager));
+  manager->shards_ = (ShardedBufferManagerShard *)aligned_alloc(_Alignof(ShardedBufferManagerShard),
+                                                                sizeof(ShardedBufferManagerShard) * shard_num);
+  manager->shard_num_ = shard_num;
+  manager->pool_size = pool_size;
+
+  // The frames are split as evenly as possible, the first shards take the remainder
+  frame_id_t frame_base = 0;
+  for (size_t i = 0; i < shard_num; ++i) {
+    ShardedBufferManagerShard *shard = &manager->shards_[i];
+    const size_t shard_pool_size = pool_size / shard_num + (i < pool_size % shard_num ? 1 : 0);
+    pthread_mutex_init(&shard->lock_, NULL);
+    atomic_init(&shard->sequence_, 0);
+    shard->manager_ = BufferManagerInit(shard_pool_size, create_replacer(shard_pool_size));
+    shard->frame_base_ = frame_base;
+    shard->pool_size_ = shard_pool_size;
+    shard->access_num_ = 0;
+    frame_base += (frame_id_t)shard_pool_size;
+  }
+  return manager;
+}
+
+void ShardedBufferManagerDestroy(ShardedBufferManager *manager) {
+  for (size_t i = 0; i < manager->shard_num_; ++i) {
+    pthread_mutex_destroy(&manager->shards_[i].lock_);
+    BufferManagerDestroy(manager->shards_[i].manager_);
+  }
+  free(manager->shards_);
+  free(manager);
+}
+
+// Fetch a page with the shard locked, lookups without the lock see the page table change
+static frame_id_t ShardedBufferManagerFetchLocked(ShardedBufferManagerShard *shard, page_id_t page_id) {
+  const unsigned sequence = atomic_load_explicit(&shard->sequence_, memory_order_relaxed);
+  atomic_store_explicit(&shard->sequence_, sequence + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  frame_id_t frame_id = BufferManagerAccessPage(shard->manager_, page_id);
+  atomic_store_explicit(&shard->sequence_, sequence + 2, memory_order_release);
+  if (frame_id != -1) {
+    shard->access_num_++;
+    frame_id += shard->frame_base_;
+  }
+  return frame_id;
+}
+
+frame_id_t ShardedBufferManagerFetchPage(ShardedBufferManager *manager, page_id_t page_id) {
+  ShardedBufferManagerShard *shard = &manager->shards_[ShardedBufferManagerShardOf(manager, page_id)];
+  pthread_mutex_lock(&shard->lock_);
+  const frame_id_t frame_id = ShardedBufferManagerFetchLocked(shard, page_id);
+  pthread_mutex_unlock(&shard->lock_);
+  return frame_id;
+}
+
+// Look a page up without the lock, -1 if it isn't there or the page table changed meanwhile. The page table never
+// reallocates and both sides access its bytes and slots atomically, so a lookup racing with a writer reads stale
+// slots but stays inside the table, and the sequence number tells whether the result can be trusted.
+static frame_id_t ShardedBufferManagerLookupOptimistic(ShardedBufferManagerShard *shard, page_id_t page_id) {
+  const unsigned sequence = atomic_load_explicit(&shard->sequence_, memory_order_acquire);
+  if (sequence & 1) {
+    return -1;
+  }
+  const frame_id_t frame_id = PageTableFindConcurrent(shard->manager_->page_table_, page_id);
+  atomic_thread_fence(memory_order_acquire);
+  if (atomic_load_explicit(&shard->sequence_, memory_order_relaxed) != sequence) {
+    return -1;
+  }
+  return frame_id;
+}
+
+// Hand the queued hits of a shard to its replacer, the shard must be locked
+static void ShardedBufferManagerDrain(ShardedBufferManagerShard *shard, ShardedBufferManagerPendingHits *pending) {
+  // A frame evicted after its hit holds another page now, the hit is counted but the replacer must not see it
+  size_t valid_num = 0;
+  for (size_t i = 0; i < pending->size_; ++i) {
+    if (shard->manager_->pages_[pending->frame_ids_[i]] == pending->page_ids_[i]) {
+      pending->frame_ids_[valid_num++] = pending->frame_ids_[i];
+    }
+  }
+  if (valid_num > 0) {
+    AnyReplacerRecordHits(shard->manager_->replacer_, pending->frame_ids_, valid_num);
+  }
+  shard->access_num_ += pending->size_;
+  pending->size_ = 0;
+}
+
+ShardedBufferManagerHitBuffer *ShardedBufferManagerHitBufferInit(ShardedBufferManager *manager) {
+  ShardedBufferManagerHitBuffer *buffer =
+      (ShardedBufferManagerHitBuffer *)malloc(sizeof(ShardedBufferManagerHitBuffer));
+  buffer->manager_ = manager;
+  buffer->pending_ =
+      (ShardedBufferManagerPendingHits *)malloc(sizeof(ShardedBufferManagerPendingHits) * manager->shard_num_);
+  for (size_t i = 0; i < manager->shard_num_; ++i) {
+    buffer->pending_[i].size_ = 0;
+  }
+  return buffer;
+}
+
+void ShardedBufferManagerHitBufferDestroy(ShardedBufferManagerHitBuffer *buffer) {
+  ShardedBufferManagerHitBufferFlush(buffer);
+  free(buffer->pending_);
+  free(buffer);
+}
+
+void ShardedBufferManagerHitBufferFlush(ShardedBufferManagerHitBuffer *buffer) {
+  for (size_t i = 0; i < buffer->manager_->shard_num_; ++i) {
+    if (buffer->pending_[i].size_ > 0) {
+      ShardedBufferManagerShard *shard = &buffer->manager_->shards_[i];
+      pthread_mutex_lock(&shard->lock_);
+      ShardedBufferManagerDrain(shard, &buffer->pending_[i]);
+      pthread_mutex_unlock(&shard->lock_);
+    }
+  }
+}
+
+frame_id_t ShardedBufferManagerFetchPageBuffered(ShardedBufferManagerHitBuffer *buffer, page_id_t page_id) {
+  const size_t shard_index = ShardedBufferManagerShardOf(buffer->manager_, page_id);
+  ShardedBufferManagerShard *shard = &buffer->manager_->shards_[shard_index];
+  ShardedBufferManagerPendingHits *pending = &buffer->pending_[shard_index];
+
+  const frame_id_t frame_id = ShardedBufferManagerLookupOptimistic(shard, page_id);
+  if (frame_id != -1) {
+    pending->frame_ids_[pending->size_] = frame_id;
+    pending->page_ids_[pending->size_] = page_id;
+    pending->size_++;
+    // Like BP-Wrapper, a half full queue is drained only if the lock is free, a full one waits for it
+    if (pending->size_ == SHARDED_HIT_BUFFER_SIZE) {
+      pthread_mutex_lock(&shard->lock_);
+      ShardedBufferManagerDrain(shard, pending);
+      pthread_mutex_unlock(&shard->lock_);
+    } else if (pending->size_ >= SHARDED_HIT_BUFFER_SIZE / 2 && pthread_mutex_trylock(&shard->lock_) == 0) {
+      ShardedBufferManagerDrain(shard, pending);
+      pthread_mutex_unlock(&shard->lock_);
+    }
+    return frame_id + shard->frame_base_;
+  }
+
+  // A miss, or the page table changed during the lookup. The queued hits go first so the replacer sees this
+  // thread's accesses in order.
+  pthread_mutex_lock(&shard->lock_);
+  ShardedBufferManagerDrain(shard, pending);
+  const frame_id_t fetched_frame_id = ShardedBufferManagerFetchLocked(shard, page_id);
+  pthread_mutex_unlock(&shard->lock_);
+  return fetched_frame_id;
+}
+
+void ShardedBufferManagerGetMissNum(ShardedBufferManager *manager, size_t *compulsory_miss_num,
+                                    size_t *capacity_miss_num) {
+  *compulsory_miss_num = 0;
+  *capacity_miss_num = 0;
+  for (size_t i = 0; i < manager->shard_num_; ++i) {
+    ShardedBufferManagerShard *shard = &manager->shards_[i];
+    size_t shard_compulsory_miss_num;
+    size_t shard_capacity_miss_num;
+    pthread_mutex_lock(&shard->lock_);
+    BufferManagerGetMissNum(shard->manager_, &shard_compulsory_miss_num, &shard_capacity_miss_num);
+    pthread_mutex_unlock(&shard->lock_);
+    *compulsory_miss_num += shard_compulsory_miss_num;
+    *capacity_miss_num += shard_capacity_miss_num;
+  }
+}
+
+size_t ShardedBufferManagerGetHitNum(ShardedBufferManager *manager) {
+  size_t hit_num = 0;
+  for (size_t i = 0; i < manager->shard_num_; ++i) {
+    ShardedBufferManagerShard *shard = &manager->shards_[i];
+    size_t compulsory_miss_num;
+    size_t capacity_miss_num;
+    pthread_mutex_lock(&shard->lock_);
+    BufferManagerGetMissNum(shard->manager_, &compulsory_miss_num, &capacity_miss_num);
+    hit_num += shard->access_num_ - compulsory_miss_num - capacity_miss_num;
+    pthread_mutex_unlock(&shard->lock_);
+  }
+  return hit_num;
+}
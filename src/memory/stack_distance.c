@@ -0,0 +1,118 @@
+#include "memory/stack_distance.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// Stack Distance Analyzer Implementation
+//===----------------------------------------------------------------------===//
+static const size_t INITIAL_TREE_SIZE = 1024;
+
+StackDistanceAnalyzer *StackDistanceAnalyzerInit(size_t max_pool_size) {
+  StackDistanceAnalyzer *analyzer = (StackDistanceAnalyzer *)malloc(sizeof(StackDistanceAnalyzer));
+  analyzer->tree_size_ = INITIAL_TREE_SIZE;
+  analyzer->tree_ = (size_t *)calloc(analyzer->tree_size_ + 1, sizeof(size_t));
+  analyzer->last_access_ = LastAccessTable_init();
+  analyzer->distance_num_ = (size_t *)calloc(max_pool_size, sizeof(size_t));
+  analyzer->max_pool_size_ = max_pool_size;
+  analyzer->far_access_num_ = 0;
+  analyzer->cold_miss_num_ = 0;
+  analyzer->access_num_ = 0;
+  analyzer->current_timestamp_ = 0;
+  return analyzer;
+}
+
+void StackDistanceAnalyzerDestroy(StackDistanceAnalyzer *analyzer) {
+  free(analyzer->tree_);
+  LastAccessTable_drop(&analyzer->last_access_);
+  free(analyzer->distance_num_);
+  free(analyzer);
+}
+
+// Number of marked timestamps below the given one
+static size_t StackDistancePrefix(const StackDistanceAnalyzer *analyzer, size_t timestamp) {
+  size_t sum = 0;
+  for (size_t i = timestamp; i > 0; i -= i & (~i + 1)) {
+    sum += analyzer->tree_[i];
+  }
+  return sum;
+}
+
+static void StackDistanceMark(StackDistanceAnalyzer *analyzer, size_t timestamp, bool marked) {
+  for (size_t i = timestamp + 1; i <= analyzer->tree_size_; i += i & (~i + 1)) {
+    if (marked) {
+      analyzer->tree_[i]++;
+    } else {
+      analyzer->tree_[i]--;
+    }
+  }
+}
+
+// Renumber the latest accesses to 0..D-1 in order once the timestamps run out, D being the number of distinct pages
+static void StackDistanceCompact(StackDistanceAnalyzer *analyzer) {
+  const size_t page_num = (size_t)LastAccessTable_size(&analyzer->last_access_);
+  size_t *rank = (size_t *)calloc(analyzer->tree_size_, sizeof(size_t));
+  for (LastAccessTable_iter it = LastAccessTable_begin(&analyzer->last_access_); it.ref; LastAccessTable_next(&it)) {
+    rank[it.ref->second] = 1;
+  }
+  size_t next_rank = 0;
+  for (size_t timestamp = 0; timestamp < analyzer->tree_size_; ++timestamp) {
+    if (rank[timestamp]) {
+      rank[timestamp] = next_rank++;
+    }
+  }
+  for (LastAccessTable_iter it = LastAccessTable_begin(&analyzer->last_access_); it.ref; LastAccessTable_next(&it)) {
+    it.ref->second = rank[it.ref->second];
+  }
+  free(rank);
+
+  // Keep at least half of the tree free so compaction stays amortized O(1) per access
+  while (analyzer->tree_size_ < 2 * page_num) {
+    analyzer->tree_size_ *= 2;
+  }
+  free(analyzer->tree_);
+  analyzer->tree_ = (size_t *)malloc(sizeof(size_t) * (analyzer->tree_size_ + 1));
+  // Node i covers the timestamps [i - lowbit(i), i), of which the ones below page_num are marked
+  for (size_t i = 1; i <= analyzer->tree_size_; ++i) {
+    const size_t begin = i - (i & (~i + 1));
+    const size_t end = i < page_num ? i : page_num;
+    analyzer->tree_[i] = end > begin ? end - begin : 0;
+  }
+  analyzer->current_timestamp_ = page_num;
+}
+
+void StackDistanceAnalyzerAccess(StackDistanceAnalyzer *analyzer, page_id_t page_id) {
+  if (analyzer->current_timestamp_ == analyzer->tree_size_) {
+    StackDistanceCompact(analyzer);
+  }
+
+  const size_t timestamp = analyzer->current_timestamp_++;
+  analyzer->access_num_++;
+  LastAccessTable_result last = LastAccessTable_insert(&analyzer->last_access_, page_id, timestamp);
+  if (last.inserted) {
+    analyzer->cold_miss_num_++;
+  } else {
+    // Every marked timestamp between the two accesses is a distinct page touched in between
+    const size_t last_timestamp = last.ref->second;
+    const size_t distance =
+        StackDistancePrefix(analyzer, timestamp) - StackDistancePrefix(analyzer, last_timestamp + 1);
+    if (distance < analyzer->max_pool_size_) {
+      analyzer->distance_num_[distance]++;
+    } else {
+      analyzer->far_access_num_++;
+    }
+    StackDistanceMark(analyzer, last_timestamp, false);
+    last.ref->second = timestamp;
+  }
+  StackDistanceMark(analyzer, timestamp, true);
+}
+
+void StackDistanceAnalyzerMissCurve(const StackDistanceAnalyzer *analyzer, size_t *miss_num) {
+  // An access misses on c frames iff its distance is at least c
+  size_t miss = analyzer->cold_miss_num_ + analyzer->far_access_num_;
+  for (size_t pool_size = analyzer->max_pool_size_; pool_size > 0; --pool_size) {
+    miss_num[pool_size - 1] = miss;
+    miss += analyzer->distance_num_[pool_size - 1];
+  }
+}
@@ -0,0 +1,78 @@
+#include "memory/stress.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "memory/replacer.h"
+#include "memory/sharded_buffer_manager.h"
+
+//===----------------------------------------------------------------------===//
+// Stress Implementation
+//===----------------------------------------------------------------------===//
+typedef struct StressWorker {
+  ShardedBufferManager *manager_;
+  const page_id_t *pages_;
+  size_t access_num_;
+  size_t bad_frame_num_;
+  bool buffered_hits_;
+  pthread_t thread_;
+} StressWorker;
+
+static void *StressWorkerMain(void *arg) {
+  StressWorker *worker = (StressWorker *)arg;
+  const frame_id_t pool_size = (frame_id_t)worker->manager_->pool_size;
+  ShardedBufferManagerHitBuffer *buffer =
+      worker->buffered_hits_ ? ShardedBufferManagerHitBufferInit(worker->manager_) : NULL;
+  for (size_t i = 0; i < worker->access_num_; ++i) {
+    const frame_id_t frame_id = buffer != NULL ? ShardedBufferManagerFetchPageBuffered(buffer, worker->pages_[i])
+                                               : ShardedBufferManagerFetchPage(worker->manager_, worker->pages_[i]);
+    if (frame_id < 0 || frame_id >= pool_size) {
+      worker->bad_frame_num_++;
+    }
+  }
+  if (buffer != NULL) {
+    ShardedBufferManagerHitBufferDestroy(buffer);
+  }
+  return NULL;
+}
+
+static double StressNow(void) {
+  struct timespec now;
+  timespec_get(&now, TIME_UTC);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+bool StressRun(ShardedBufferManager *manager, page_id_t *const *pages, size_t access_num, size_t thread_num,
+               bool buffered_hits, StressResult *result) {
+  StressWorker *workers = (StressWorker *)calloc(thread_num, sizeof(StressWorker));
+  bool succeed = true;
+  size_t started_num = 0;
+  const double start = StressNow();
+  for (; started_num < thread_num; ++started_num) {
+    StressWorker *worker = &workers[started_num];
+    worker->manager_ = manager;
+    worker->pages_ = pages[started_num];
+    worker->access_num_ = access_num;
+    worker->buffered_hits_ = buffered_hits;
+    if (pthread_create(&worker->thread_, NULL, StressWorkerMain, worker) != 0) {
+      fprintf(stderr, "Can't start stress thread %zu\n", started_num);
+      succeed = false;
+      break;
+    }
+  }
+
+  result->access_num_ = 0;
+  result->bad_frame_num_ = 0;
+  for (size_t i = 0; i < started_num; ++i) {
+    pthread_join(workers[i].thread_, NULL);
+    result->access_num_ += workers[i].access_num_;
+    result->bad_frame_num_ += workers[i].bad_frame_num_;
+  }
+  result->seconds_ = StressNow() - start;
+  result->hit_num_ = ShardedBufferManagerGetHitNum(manager);
+  ShardedBufferManagerGetMissNum(manager, &result->compulsory_miss_num_, &result->capacity_miss_num_);
+  free(workers);
+  return succeed;
+}
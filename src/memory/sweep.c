@@ -0,0 +1,185 @@
+#include "memory/sweep.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "memory/buffer_manager.h"
+#include "memory/opt_simulator.h"
+#include "memory/page_trace.h"
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// Sweep Implementation
+//===----------------------------------------------------------------------===//
+#define SWEEP_BATCH_SIZE 4096
+
+typedef struct SweepContext {
+  SweepConfig *configs_;
+  size_t config_num_;
+  const SweepWorkload *workload_;
+  const page_id_t *trace_pages_;  // The trace decoded once for OPT and read by every worker, NULL if no OPT
+  size_t trace_access_num_;
+  atomic_size_t next_config_;  // Configurations are handed out in order
+  atomic_bool failed_;
+} SweepContext;
+
+// Everything a worker thread owns, nothing here is shared
+typedef struct SweepWorker {
+  SweepContext *context_;
+  pthread_t thread_;
+  crand_t rng_;
+  PageTraceReader *reader_;  // Own cursor over the trace file, the mapped pages are shared through the page cache
+  page_id_t *pages_;         // Reference string of pages_seed_, NULL for a trace
+  size_t access_num_;
+  uint64_t pages_seed_;
+  bool has_pages_;
+} SweepWorker;
+
+// Make pages_ hold the generated reference string of the configuration
+static void SweepLoadPages(SweepWorker *worker, const SweepConfig *config) {
+  // Consecutive configurations usually share the seed, so the reference string is kept
+  if (!worker->has_pages_ || worker->pages_seed_ != config->seed_) {
+    worker->rng_ = crand_init(config->seed_);
+    worker->context_->workload_->generate_trace_(&worker->rng_, worker->pages_);
+    worker->pages_seed_ = config->seed_;
+    worker->has_pages_ = true;
+  }
+}
+
+static void SweepRunConfig(SweepWorker *worker, SweepConfig *config) {
+  const SweepContext *context = worker->context_;
+  size_t compulsory_miss_num = 0;
+  size_t capacity_miss_num = 0;
+
+  if (config->policy_->create_replacer_ == NULL) {
+    const page_id_t *pages = context->trace_pages_;
+    size_t access_num = context->trace_access_num_;
+    if (pages == NULL) {
+      SweepLoadPages(worker, config);
+      pages = worker->pages_;
+      access_num = worker->access_num_;
+    }
+    OptSimulate(pages, access_num, config->frames_num_, &compulsory_miss_num, &capacity_miss_num);
+    config->access_num_ = access_num;
+  } else if (context->workload_->trace_path_ == NULL) {
+    SweepLoadPages(worker, config);
+    BufferManager *manager =
+        BufferManagerInit(config->frames_num_, config->policy_->create_replacer_(config->frames_num_));
+    frame_id_t frames[SWEEP_BATCH_SIZE];
+    for (size_t i = 0; i < worker->access_num_; i += SWEEP_BATCH_SIZE) {
+      const size_t rest = worker->access_num_ - i;
+      BufferManagerFetchPages(manager, worker->pages_ + i, rest < SWEEP_BATCH_SIZE ? rest : SWEEP_BATCH_SIZE, frames);
+    }
+    BufferManagerGetMissNum(manager, &compulsory_miss_num, &capacity_miss_num);
+    BufferManagerDestroy(manager);
+    config->access_num_ = worker->access_num_;
+  } else {
+    // Other policies stream the trace instead of holding it
+    BufferManager *manager =
+        BufferManagerInit(config->frames_num_, config->policy_->create_replacer_(config->frames_num_));
+    page_id_t pages[SWEEP_BATCH_SIZE];
+    frame_id_t frames[SWEEP_BATCH_SIZE];
+    size_t read_num;
+    PageTraceReaderRewind(worker->reader_);
+    while ((read_num = PageTraceReaderRead(worker->reader_, pages, SWEEP_BATCH_SIZE)) > 0) {
+      BufferManagerFetchPages(manager, pages, read_num, frames);
+    }
+    BufferManagerGetMissNum(manager, &compulsory_miss_num, &capacity_miss_num);
+    BufferManagerDestroy(manager);
+    config->access_num_ = PageTraceReaderSize(worker->reader_);
+  }
+
+  config->miss_num_ = compulsory_miss_num + capacity_miss_num;
+}
+
+static void *SweepWorkerMain(void *arg) {
+  SweepWorker *worker = (SweepWorker *)arg;
+  SweepContext *context = worker->context_;
+  for (;;) {
+    const size_t index = atomic_fetch_add(&context->next_config_, 1);
+    if (index >= context->config_num_ || atomic_load(&context->failed_)) {
+      return NULL;
+    }
+    SweepRunConfig(worker, &context->configs_[index]);
+  }
+}
+
+bool SweepRun(SweepConfig *configs, size_t config_num, const SweepWorkload *workload, size_t thread_num) {
+  if (thread_num == 0) {
+    thread_num = 1;
+  }
+  if (thread_num > config_num) {
+    thread_num = config_num;
+  }
+
+  SweepContext context;
+  context.configs_ = configs;
+  context.config_num_ = config_num;
+  context.workload_ = workload;
+  context.trace_pages_ = NULL;
+  context.trace_access_num_ = 0;
+  atomic_init(&context.next_config_, 0);
+  atomic_init(&context.failed_, false);
+
+  // OPT needs the whole reference string, the trace is decoded once here instead of by every worker
+  page_id_t *trace_pages = NULL;
+  if (workload->trace_path_ != NULL) {
+    bool has_opt = false;
+    for (size_t i = 0; i < config_num; ++i) {
+      has_opt = has_opt || configs[i].policy_->create_replacer_ == NULL;
+    }
+    if (has_opt) {
+      PageTraceReader *reader = PageTraceReaderOpen(workload->trace_path_);
+      if (reader == NULL) {
+        return false;
+      }
+      trace_pages = (page_id_t *)malloc(sizeof(page_id_t) * PageTraceReaderSize(reader));
+      context.trace_access_num_ = PageTraceReaderRead(reader, trace_pages, PageTraceReaderSize(reader));
+      context.trace_pages_ = trace_pages;
+      PageTraceReaderClose(reader);
+    }
+  }
+
+  SweepWorker *workers = (SweepWorker *)calloc(thread_num, sizeof(SweepWorker));
+  size_t started_num = 0;
+  for (; started_num < thread_num; ++started_num) {
+    SweepWorker *worker = &workers[started_num];
+    worker->context_ = &context;
+    if (workload->trace_path_ != NULL) {
+      worker->reader_ = PageTraceReaderOpen(workload->trace_path_);
+      if (worker->reader_ == NULL) {
+        atomic_store(&context.failed_, true);
+        break;
+      }
+    } else {
+      worker->pages_ = (page_id_t *)malloc(sizeof(page_id_t) * workload->generated_access_num_);
+      worker->access_num_ = workload->generated_access_num_;
+    }
+    if (pthread_create(&worker->thread_, NULL, SweepWorkerMain, worker) != 0) {
+      fprintf(stderr, "Can't start sweep thread %zu\n", started_num);
+      if (worker->reader_ != NULL) {
+        PageTraceReaderClose(worker->reader_);
+      }
+      free(worker->pages_);
+      // The threads already started finish the sweep on their own
+      if (started_num == 0) {
+        atomic_store(&context.failed_, true);
+      }
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < started_num; ++i) {
+    pthread_join(workers[i].thread_, NULL);
+    if (workers[i].reader_ != NULL) {
+      PageTraceReaderClose(workers[i].reader_);
+    }
+    free(workers[i].pages_);
+  }
+  free(workers);
+  free(trace_pages);
+  return !atomic_load(&context.failed_);
+}
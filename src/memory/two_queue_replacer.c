@@ -0,0 +1,201 @@
+#include "memory/two_queue_replacer.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "memory/ghost_pool.h"
+#include "memory/index_list.h"
+#include "memory/replacer.h"
+
+//===----------------------------------------------------------------------===//
+// 2Q Replacer Implementation
+//===----------------------------------------------------------------------===//
+enum TwoQueueList { TWOQ_NONE = 0, TWOQ_A1IN = 1, TWOQ_AM = 2 };
+enum TwoQueueFrameState { TWOQ_LIST_MASK = 0x3, TWOQ_EVICTABLE = 1 << 2 };
+enum { TWOQ_A1OUT = 1 };
+
+TwoQueueReplacer *TwoQueueReplacerInit(size_t num_frames) {
+  TwoQueueReplacer *replacer = (TwoQueueReplacer *)malloc(sizeof(TwoQueueReplacer));
+  replacer->frame_links_ = (IndexLink *)malloc(sizeof(IndexLink) * num_frames);
+  replacer->frame_state_ = (uint8_t *)calloc(num_frames, sizeof(uint8_t));
+  replacer->frame_pages_ = (page_id_t *)malloc(sizeof(page_id_t) * num_frames);
+  replacer->a1in_ = IndexListInit();
+  replacer->am_ = IndexListInit();
+  replacer->a1out_ = IndexListInit();
+  replacer->kin_ = num_frames / 4 > 0 ? num_frames / 4 : 1;
+  replacer->kout_ = num_frames / 2 > 0 ? num_frames / 2 : 1;
+  // A victim is remembered before A1out is trimmed back to kout
+  replacer->ghosts_ = GhostPoolInit(replacer->kout_ + 1);
+  replacer->curr_size_ = 0;
+  replacer->replacer_size_ = num_frames;
+  return replacer;
+}
+
+void TwoQueueReplacerDestroy(TwoQueueReplacer *replacer) {
+  free(replacer->frame_links_);
+  free(replacer->frame_state_);
+  free(replacer->frame_pages_);
+  GhostPoolDestroy(&replacer->ghosts_);
+  free(replacer);
+}
+
+static IndexList *TwoQueueResidentList(TwoQueueReplacer *replacer, uint8_t list) {
+  return list == TWOQ_A1IN ? &replacer->a1in_ : &replacer->am_;
+}
+
+// Find the oldest evictable frame of a list, -1 if there is none
+static frame_id_t TwoQueueFindVictim(TwoQueueReplacer *replacer, const IndexList *list) {
+  frame_id_t frame = list->tail_;
+  // Pinned frames are skipped, in the common case the tail itself is evictable
+  while (frame != -1 && !(replacer->frame_state_[frame] & TWOQ_EVICTABLE)) {
+    frame = replacer->frame_links_[frame].prev_;
+  }
+  return frame;
+}
+
+bool TwoQueueReplacerEvict(TwoQueueReplacer *replacer, frame_id_t *frame_id) {
+  // If no frame is evictable, return false directly
+  if (replacer->curr_size_ == 0) {
+    return false;
+  }
+
+  const bool prefer_a1in = replacer->a1in_.size_ > replacer->kin_;
+  uint8_t list = prefer_a1in ? TWOQ_A1IN : TWOQ_AM;
+  frame_id_t victim = TwoQueueFindVictim(replacer, TwoQueueResidentList(replacer, list));
+  if (victim == -1) {
+    list = prefer_a1in ? TWOQ_AM : TWOQ_A1IN;
+    victim = TwoQueueFindVictim(replacer, TwoQueueResidentList(replacer, list));
+  }
+
+  IndexListRemove(TwoQueueResidentList(replacer, list), replacer->frame_links_, victim);
+  replacer->frame_state_[victim] = TWOQ_NONE;
+  // Only pages leaving A1in are remembered, pages leaving Am had their chance
+  if (list == TWOQ_A1IN && replacer->frame_pages_[victim] != -1) {
+    GhostPoolPush(&replacer->ghosts_, &replacer->a1out_, TWOQ_A1OUT, replacer->frame_pages_[victim]);
+    if (replacer->a1out_.size_ > replacer->kout_) {
+      GhostPoolPopBack(&replacer->ghosts_, &replacer->a1out_);
+    }
+  }
+
+  *frame_id = victim;
+  replacer->curr_size_--;
+  return true;
+}
+
+void TwoQueueReplacerRecordAccess(TwoQueueReplacer *replacer, frame_id_t frame_id) {
+  // Frame id is invalid
+  if ((size_t)frame_id >= replacer->replacer_size_) {
+    fprintf(stderr, "frame_id should be less than replacer_size\n");
+    return;
+  }
+
+  uint8_t *state = &replacer->frame_state_[frame_id];
+  switch (*state & TWOQ_LIST_MASK) {
+    case TWOQ_NONE:
+      // The frame was not admitted, track it as a new page of unknown identity
+      replacer->frame_pages_[frame_id] = -1;
+      IndexListPushFront(&replacer->a1in_, replacer->frame_links_, frame_id);
+      *state = TWOQ_A1IN;
+      break;
+    case TWOQ_AM:
+      IndexListMoveToFront(&replacer->am_, replacer->frame_links_, frame_id);
+      break;
+    default:
+      // Correlated re-accesses while on A1in don't make a page hot
+      break;
+  }
+}
+
+void TwoQueueReplacerSetEvictable(TwoQueueReplacer *replacer, frame_id_t frame_id, bool set_evictable) {
+  // If the frame doesn't exist, directly return
+  if ((size_t)frame_id >= replacer->replacer_size_ ||
+      (replacer->frame_state_[frame_id] & TWOQ_LIST_MASK) == TWOQ_NONE) {
+    fprintf(stderr, "Frame %d doesn't exist\n", frame_id);
+    return;
+  }
+
+  uint8_t *state = &replacer->frame_state_[frame_id];
+  bool original_evictable = *state & TWOQ_EVICTABLE;
+  // If the evictable field of the given frame has not changed, return directly
+  if (set_evictable == original_evictable) {
+    return;
+  }
+
+  if (set_evictable) {
+    *state |= TWOQ_EVICTABLE;
+    replacer->curr_size_++;
+  } else {
+    *state &= (uint8_t)~TWOQ_EVICTABLE;
+    replacer->curr_size_--;
+  }
+}
+
+void TwoQueueReplacerAdmit(TwoQueueReplacer *replacer, frame_id_t frame_id, page_id_t page_id) {
+  // Frame id is invalid
+  if ((size_t)frame_id >= replacer->replacer_size_) {
+    fprintf(stderr, "frame_id should be less than replacer_size\n");
+    return;
+  }
+
+  uint8_t *state = &replacer->frame_state_[frame_id];
+  if ((*state & TWOQ_LIST_MASK) != TWOQ_NONE) {
+    // The frame is already tracked, re-admit it with the new page
+    IndexListRemove(TwoQueueResidentList(replacer, *state & TWOQ_LIST_MASK), replacer->frame_links_, frame_id);
+  }
+  const uint8_t evictable = *state & TWOQ_EVICTABLE;
+  replacer->frame_pages_[frame_id] = page_id;
+
+  const int32_t ghost = GhostPoolFind(&replacer->ghosts_, page_id);
+  if (ghost == -1) {
+    IndexListPushFront(&replacer->a1in_, replacer->frame_links_, frame_id);
+    *state = (uint8_t)(TWOQ_A1IN | evictable);
+  } else {
+    // Faulted again after leaving A1in, the page is hot
+    GhostPoolRemove(&replacer->ghosts_, &replacer->a1out_, ghost);
+    IndexListPushFront(&replacer->am_, replacer->frame_links_, frame_id);
+    *state = (uint8_t)(TWOQ_AM | evictable);
+  }
+}
+
+void TwoQueueReplacerRecordHits(TwoQueueReplacer *replacer, const frame_id_t *frame_ids, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    TwoQueueReplacerRecordAccess(replacer, frame_ids[i]);
+    TwoQueueReplacerSetEvictable(replacer, frame_ids[i], true);
+  }
+}
+
+size_t TwoQueueReplacerSize(TwoQueueReplacer *replacer) { return replacer->curr_size_; }
+
+size_t TwoQueueReplacerMemoryUsage(TwoQueueReplacer *replacer) {
+  const size_t frame_size = sizeof(IndexLink) + sizeof(uint8_t) + sizeof(page_id_t);
+  return sizeof(TwoQueueReplacer) + replacer->replacer_size_ * frame_size + GhostPoolMemoryUsage(&replacer->ghosts_);
+}
+//===----------------------------------------------------------------------===//
+// Replacer interface implementation
+//===----------------------------------------------------------------------===//
+static bool TwoQueueEvict(void *replacer, frame_id_t *frame_id) { return TwoQueueReplacerEvict(replacer, frame_id); }
+
+static void TwoQueueRecordAccess(void *replacer, frame_id_t frame_id) {
+  TwoQueueReplacerRecordAccess(replacer, frame_id);
+}
+
+static void TwoQueueRecordHits(void *replacer, const frame_id_t *frame_ids, size_t n) {
+  TwoQueueReplacerRecordHits(replacer, frame_ids, n);
+}
+
+static void TwoQueueSetEvictable(void *replacer, frame_id_t frame_id, bool set_evictable) {
+  TwoQueueReplacerSetEvictable(replacer, frame_id, set_evictable);
+}
+
+static void TwoQueueAdmit(void *replacer, frame_id_t frame_id, page_id_t page_id) {
+  TwoQueueReplacerAdmit(replacer, frame_id, page_id);
+}
+
+static size_t TwoQueueSize(void *replacer) { return TwoQueueReplacerSize(replacer); }
+
+static size_t TwoQueueMemoryUsage(void *replacer) { return TwoQueueReplacerMemoryUsage(replacer); }
+
+static void TwoQueueDestroy(void *replacer) { TwoQueueReplacerDestroy(replacer); }
+
+const ReplacerVTable TwoQueueReplacerVTable = {TwoQueueEvict,        TwoQueueRecordAccess, TwoQueueRecordHits,
+                                               TwoQueueSetEvictable, TwoQueueAdmit,        TwoQueueSize,
+                                               TwoQueueMemoryUsage,  TwoQueueDestroy};
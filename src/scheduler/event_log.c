@@ -0,0 +1,137 @@
+#include "scheduler/event_log.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "scheduler/sim_engine.h"
+
+//===----------------------------------------------------------------------===//
+// Event Log Implementation
+//===----------------------------------------------------------------------===//
+static const char EVENT_LOG_MAGIC[8] = {'S', 'C', 'H', 'D', 'L', 'O', 'G', '\0'};
+
+static const char *const BURST_END_NAMES[] = {"finished", "expired", "yielded", "preempted"};
+
+// The longest CSV line, two 64-bit numbers with their sign, a 32-bit pid and the longest end name
+#define EVENT_LOG_MAX_LINE 64
+
+static void event_log_put_u64(char *out, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    out[i] = (char)(uint8_t)(value >> (8 * i));
+  }
+}
+
+static void event_log_put_u32(char *out, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    out[i] = (char)(uint8_t)(value >> (8 * i));
+  }
+}
+
+// Write the decimal digits of value to out and return their number
+static size_t event_log_put_decimal(char *out, int64_t value) {
+  size_t length = 0;
+  uint64_t rest = (uint64_t)value;
+  if (value < 0) {
+    out[length++] = '-';
+    rest = -rest;
+  }
+  char digits[20];
+  size_t digit_num = 0;
+  do {
+    digits[digit_num++] = (char)('0' + rest % 10);
+    rest /= 10;
+  } while (rest != 0);
+  while (digit_num > 0) {
+    out[length++] = digits[--digit_num];
+  }
+  return length;
+}
+
+static void event_log_encode_header(char *header, uint64_t record_num) {
+  memcpy(header, EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC));
+  event_log_put_u32(header + 8, EVENT_LOG_VERSION);
+  event_log_put_u32(header + 12, 0);
+  event_log_put_u64(header + 16, record_num);
+}
+
+static void event_log_flush(EventLog *log) {
+  if (log->size_ != 0 && fwrite(log->buffer_, 1, log->size_, log->file_) != log->size_) {
+    log->failed_ = true;
+  }
+  log->size_ = 0;
+}
+
+EventLog *event_log_open(const char *path, EventLogFormat format) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    fprintf(stderr, "Can't create event log %s\n", path);
+    return NULL;
+  }
+  EventLog *log = (EventLog *)malloc(sizeof(EventLog));
+  log->file_ = file;
+  log->format_ = format;
+  log->buffer_ = (char *)malloc(EVENT_LOG_BUFFER_SIZE);
+  log->size_ = 0;
+  log->record_num_ = 0;
+  log->failed_ = false;
+  // The binary header holds the number of bursts, which is only known on close, a placeholder is written for now
+  if (format == EVENT_LOG_BINARY) {
+    event_log_encode_header(log->buffer_, 0);
+    log->size_ = EVENT_LOG_HEADER_SIZE;
+  } else {
+    static const char header[] = "time,pid,length,end\n";
+    memcpy(log->buffer_, header, sizeof(header) - 1);
+    log->size_ = sizeof(header) - 1;
+  }
+  // No stdio buffering under the buffer of the log, the full buffer goes straight to the file
+  setvbuf(file, NULL, _IONBF, 0);
+  return log;
+}
+
+void event_log_write(EventLog *log, const Burst *burst) {
+  if (log->size_ + EVENT_LOG_MAX_LINE > EVENT_LOG_BUFFER_SIZE) {
+    event_log_flush(log);
+  }
+  char *out = log->buffer_ + log->size_;
+  if (log->format_ == EVENT_LOG_BINARY) {
+    event_log_put_u64(out, (uint64_t)burst->start);
+    event_log_put_u64(out + 8, (uint64_t)burst->length);
+    event_log_put_u32(out + 16, burst->job->pid);
+    event_log_put_u32(out + 20, (uint32_t)burst->end);
+    log->size_ += EVENT_LOG_RECORD_SIZE;
+  } else {
+    size_t length = event_log_put_decimal(out, burst->start);
+    out[length++] = ',';
+    length += event_log_put_decimal(out + length, burst->job->pid);
+    out[length++] = ',';
+    length += event_log_put_decimal(out + length, burst->length);
+    out[length++] = ',';
+    const char *name = BURST_END_NAMES[burst->end];
+    const size_t name_length = strlen(name);
+    memcpy(out + length, name, name_length);
+    length += name_length;
+    out[length++] = '\n';
+    log->size_ += length;
+  }
+  log->record_num_++;
+}
+
+bool event_log_close(EventLog *log) {
+  event_log_flush(log);
+  bool succeed = !log->failed_;
+  if (log->format_ == EVENT_LOG_BINARY) {
+    char header[EVENT_LOG_HEADER_SIZE];
+    event_log_encode_header(header, log->record_num_);
+    succeed = succeed && fseek(log->file_, 0, SEEK_SET) == 0 &&
+              fwrite(header, 1, sizeof(header), log->file_) == sizeof(header);
+  }
+  succeed = fclose(log->file_) == 0 && succeed;
+  if (!succeed) {
+    fprintf(stderr, "Can't finish the event log\n");
+  }
+  free(log->buffer_);
+  free(log);
+  return succeed;
+}
@@ -1,7 +1,17 @@
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "argparse.h"
 #include "scheduler.h"
+#include "scheduler/event_log.h"
+#include "scheduler/sim_engine.h"
+#include "scheduler/workload.h"
+
+// Run the jobs of an open system as they arrive, from a trace or drawn from the arrival and runtime distributions
+int run_open_system(Policy policy, const char *policy_name, int seed, int jobnum, int horizon, const char *arrival_spec,
+                    const char *runtime_spec, const char *trace_path, int time_slice, int numQueues, int boost,
+                    const RunOptions *run_options);
 
 int main(int argc, const char *argv[]) {
   if (argc == 1) {
@@ -16,6 +26,14 @@ int main(int argc, const char *argv[]) {
   // Default value is 0, which means no boost
   int boost = 0;
   const char *policy_name = NULL;
+  // An open system where jobs arrive over time, either from a trace or drawn from distributions
+  const char *arrival_spec = NULL;
+  const char *runtime_spec = "uniform:0:20000";
+  const char *trace_path = NULL;
+  int horizon = 0;  // No arrivals after this time, 0 for no limit
+  int quiet = 0;
+  const char *log_path = NULL;
+  const char *log_format = "csv";
 
   // Parse the command line
   struct argparse_option options[] = {
@@ -27,6 +45,14 @@ int main(int argc, const char *argv[]) {
       OPT_INTEGER('b', "boost", &boost, "how often to boost the priority of all jobs back to high priority", NULL, 0,
                   0),
       OPT_STRING('p', "policy", &policy_name, "policy", NULL, 0, 0),
+      OPT_STRING('a', "arrival", &arrival_spec, "let jobs arrive over time, inter-arrival time distribution", NULL, 0,
+                 0),
+      OPT_STRING('r', "runtime", &runtime_spec, "runtime distribution of arriving jobs", NULL, 0, 0),
+      OPT_STRING('t', "trace", &trace_path, "let jobs arrive from a trace of arrival and runtime lines", NULL, 0, 0),
+      OPT_INTEGER('T', "horizon", &horizon, "stop arrivals after this time", NULL, 0, 0),
+      OPT_BOOLEAN(0, "quiet", &quiet, "print only the summary statistics", NULL, 0, 0),
+      OPT_STRING('l', "log", &log_path, "record every burst into this file", NULL, 0, 0),
+      OPT_STRING(0, "log-format", &log_format, "format of the burst log, csv or binary", NULL, 0, 0),
       OPT_END()};
 
   // Convert arguments into number of jobs, random seed, and policy
@@ -37,40 +63,115 @@ int main(int argc, const char *argv[]) {
   // Set the random seed from argument
   srand(seed);
 
-  Job *joblist = init_joblist(jobnum);
   Policy policy = get_policy(policy_name);
-  switch (policy) {
-    case FIFO: {
-      char policy[] = "FIFO";
-      printf("Current Policy: %s\n", policy);
-      print_joblist(joblist, jobnum);
-      printf("\n\n");
-      fifo_statistics(joblist, jobnum);
-    } break;
-    case SJF: {
-      // For Shortest job first, just sort the original job queue by runtime and execute FIFO policy
-      char policy[] = "SJF";
-      printf("Current Policy: %s\n", policy);
-      print_joblist(joblist, jobnum);
-      sjf_sort(joblist, jobnum);
-      printf("\n\n");
-      fifo_statistics(joblist, jobnum);
-    } break;
-    case RR: {
-      char policy[] = "RR";
-      printf("Current Policy: %s\n", policy);
-      print_joblist(joblist, jobnum);
-      printf("\n\n");
-      rr_statistics(joblist, jobnum, time_slice);
-    } break;
-    case MLFQ: {
-      char policy[] = "MLFQ";
-      printf("Current Policy: %s\n", policy);
+  if (policy == MLFQ && (numQueues < 1 || numQueues > MLFQ_MAX_QUEUES)) {
+    fprintf(stderr, "Invalid number of queues: %d, MLFQ takes 1 to %d queues\n", numQueues, MLFQ_MAX_QUEUES);
+    exit(EXIT_FAILURE);
+  }
+  RunOptions run_options = {.quiet = quiet != 0, .log = NULL};
+  if (log_path != NULL) {
+    EventLogFormat format = EVENT_LOG_CSV;
+    if (strcmp(log_format, "binary") == 0) {
+      format = EVENT_LOG_BINARY;
+    } else if (strcmp(log_format, "csv") != 0) {
+      fprintf(stderr, "Invalid log format: %s, use csv or binary\n", log_format);
+      exit(EXIT_FAILURE);
+    }
+    run_options.log = event_log_open(log_path, format);
+    if (run_options.log == NULL) {
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  int status = 0;
+  if (arrival_spec != NULL || trace_path != NULL) {
+    status = run_open_system(policy, policy_name, seed, jobnum, horizon, arrival_spec, runtime_spec, trace_path,
+                             time_slice, numQueues, boost, &run_options);
+  } else {
+    Job *joblist = init_joblist(jobnum);
+    if (!run_options.quiet) {
+      printf("Current Policy: %s\n", policy_name);
       print_joblist(joblist, jobnum);
       printf("\n\n");
-      mlfq_statistics(joblist, jobnum, numQueues, time_slice, boost);
-    } break;
+    }
+    switch (policy) {
+      case FIFO:
+        fifo_statistics(joblist, jobnum, &run_options);
+        break;
+      case SJF:
+        // For Shortest job first, just sort the original job queue by runtime and execute FIFO policy
+        sjf_sort(joblist, jobnum);
+        fifo_statistics(joblist, jobnum, &run_options);
+        break;
+      case STCF:
+        // Shortest time to completion first preempts the running job for a shorter one, all jobs arrive at once here
+        stcf_statistics(joblist, jobnum, &run_options);
+        break;
+      case RR:
+        rr_statistics(joblist, jobnum, time_slice, &run_options);
+        break;
+      case MLFQ:
+        mlfq_statistics(joblist, jobnum, numQueues, time_slice, boost, &run_options);
+        break;
+    }
+    free(joblist);  // Free the memory to avoid memory leak
   }
-  free(joblist);  // Free the memory to avoid memory leak
+
+  if (run_options.log != NULL && !event_log_close(run_options.log)) {
+    status = EXIT_FAILURE;
+  }
+  return status;
+}
+
+int run_open_system(Policy policy, const char *policy_name, int seed, int jobnum, int horizon, const char *arrival_spec,
+                    const char *runtime_spec, const char *trace_path, int time_slice, int numQueues, int boost,
+                    const RunOptions *run_options) {
+  if (jobnum < 0 || horizon < 0) {
+    fprintf(stderr, "Invalid number of jobs or horizon\n");
+    return EXIT_FAILURE;
+  }
+
+  Workload *workload = NULL;
+  if (trace_path != NULL) {
+    workload = workload_open_trace(trace_path, jobnum, horizon);
+    if (workload == NULL) {
+      fprintf(stderr, "Can't open trace %s\n", trace_path);
+      return EXIT_FAILURE;
+    }
+  } else {
+    Distribution interarrival;
+    Distribution service;
+    if (!parse_distribution(arrival_spec, &interarrival) || !parse_distribution(runtime_spec, &service)) {
+      fprintf(stderr, "Invalid distribution, use const:V, uniform:LOW:HIGH, exp:MEAN, pareto:ALPHA:MIN or "
+                      "bimodal:SHORT:LONG:P\n");
+      return EXIT_FAILURE;
+    }
+    if (jobnum == 0 && horizon == 0) {
+      // Jobs would arrive forever
+      fprintf(stderr, "Limit the arriving jobs with --jobs or --horizon\n");
+      return EXIT_FAILURE;
+    }
+    if (jobnum == 0 && distribution_mean(&interarrival) == 0) {
+      // Every job would arrive at time 0, the horizon is never reached
+      fprintf(stderr, "Limit the arriving jobs with --jobs, the inter-arrival time is always 0\n");
+      return EXIT_FAILURE;
+    }
+    workload = workload_init(interarrival, service, (uint64_t)seed, jobnum, horizon);
+  }
+
+  if (!run_options->quiet) {
+    printf("Current Policy: %s\n", policy_name);
+    if (trace_path != NULL) {
+      printf("Trace: %s\n", trace_path);
+    } else {
+      printf("Arrival: %s, Runtime: %s, Offered Load: %.4f\n", arrival_spec, runtime_spec,
+             distribution_mean(&workload->service_) / distribution_mean(&workload->interarrival_));
+    }
+    printf("\n\n");
+  }
+
+  const JobSource source = {.next = workload_next, .state = workload};
+  open_statistics(&source, policy, time_slice, numQueues, boost, run_options);
+  workload_destroy(workload);
   return 0;
 }
@@ -11,16 +11,22 @@
 
 #include "scheduler.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
+#include "scheduler/sim_engine.h"
 
-#define i_type VecDeque
-#define i_key_class JobDeque
-#include "stc/cvec.h"
+// A queue of processes linked through their next, so whole queues splice in constant time
+typedef struct JobList {
+  Job *head;
+  Job *tail;
+} JobList;
 
-int find_queue(VecDeque *queues);
+int find_queue(uint64_t nonempty);
+
+static void run_joblist(Job *joblist, int jobnum, Policy policy, int time_slice, int numQueues, int boost,
+                        const RunOptions *options);
 
 /**
  * @brief Initialize the list of jobs
@@ -32,7 +38,8 @@ Job *init_joblist(int jobnum) {
   struct Job *p = (struct Job *)malloc(jobnum * sizeof(struct Job));
   for (int i = 0; i < jobnum; i++) {
     // Initialize a job with random runtime, runtime between 0 and 20000
-    Job job = {.pid = i, .runtime = rand() % 20000};
+    unsigned int runtime = rand() % 20000;
+    Job job = {.pid = i, .runtime = runtime, .remaining = runtime, .arrival = 0};
     p[i] = job;
   }
   return p;
@@ -52,6 +59,9 @@ Policy get_policy(const char *policy) {
   if (strcmp(policy, "SJF") == 0) {
     return SJF;
   }
+  if (strcmp(policy, "STCF") == 0) {
+    return STCF;
+  }
   if (strcmp(policy, "RR") == 0) {
     return RR;
   }
@@ -63,255 +73,353 @@ Policy get_policy(const char *policy) {
   }
 }
 
-void fifo_statistics(Job *joblist, int jobnum) {
-  int currtime = 0;  // Current time
-  int turnaroundSum = 0, responseSum = 0;
-  int response = 0, turnaround = 0;  // Current process response, wait, turnaround time
+// Round robin over a single ready queue. With a time slice of 0 every job runs to completion in the order it arrived,
+// which is FIFO.
+typedef struct RoundRobin {
+  JobDeque ready;
+  int time_slice;
+} RoundRobin;
+
+static void rr_ready(void *policy, Job *job, ReadyReason reason, int64_t now) {
+  (void)reason;
+  (void)now;
+  // Push the process to the tail of the queue
+  JobDeque_push_back(&((RoundRobin *)policy)->ready, job);
+}
 
-  for (int i = 0; i < jobnum; i++) {
-    printf("[time %6d ] Run process %d for %d secs (Finished at %d)\n", currtime, joblist[i].pid, joblist[i].runtime,
-           currtime + joblist[i].runtime);
-    currtime += joblist[i].runtime;
+static Job *rr_dispatch(void *policy, int64_t now, int64_t *slice) {
+  (void)now;
+  RoundRobin *rr = (RoundRobin *)policy;
+  if (JobDeque_empty(&rr->ready)) {
+    return NULL;
   }
+  Job *job = *JobDeque_front(&rr->ready);  // Get the first process in the queue
+  JobDeque_pop_front(&rr->ready);          // Pop the process from the queue
+  *slice = rr->time_slice;
+  return job;
+}
 
-  currtime = 0;
-  printf("\nFinal Statistics:\n");
-  for (int i = 0; i < jobnum; i++) {
-    response = currtime;
-    turnaround = currtime + joblist[i].runtime;
-    printf("Process %3d -- Response: %6d, Turnaround: %6d\n", joblist[i].pid, response, turnaround);
-    responseSum += response;
-    turnaroundSum += turnaround;
-    currtime += joblist[i].runtime;
-  }
-  printf("\nAverage Response: %6d, Average Turnaround: %6d\n", responseSum / jobnum, turnaroundSum / jobnum);
+static void rr_burst_done(void *policy, const Burst *burst) {
+  (void)policy;
+  const long long start = burst->start;
+  const long long length = burst->length;
+  if (burst->end == BURST_FINISHED) {
+    printf("[time %6lld ] Run process %d for %lld secs (Finished at %lld)\n", start, burst->job->pid, length,
+           start + length);
+    return;
+  }
+  printf("[time %6lld ] Run process %d for %lld secs\n", start, burst->job->pid, length);
+  if (burst->end == BURST_YIELDED) {
+    printf("process %d yields\n", burst->job->pid);
+  }
 }
 
-void sjf_sort(Job *joblist, int jobnum) {
-  for (int i = 1; i < jobnum; i++) {
-    Job temp = joblist[i];
-    int j = i - 1;
+static const SchedulerOps rr_ops = {.ready = rr_ready, .dispatch = rr_dispatch, .burst_done = rr_burst_done};
 
-    while (j >= 0 && joblist[j].runtime > temp.runtime) {
-      joblist[j + 1] = joblist[j];
-      j--;
-    }
+void fifo_statistics(Job *joblist, int jobnum, const RunOptions *options) {
+  run_joblist(joblist, jobnum, FIFO, 0, 0, 0, options);
+}
 
-    joblist[j + 1] = temp;
+// Equal runtimes keep their pid order, as the pids of a new list are in list order the sort is stable
+static int compare_runtime(const void *lhs, const void *rhs) {
+  const Job *lhs_job = (const Job *)lhs;
+  const Job *rhs_job = (const Job *)rhs;
+  if (lhs_job->runtime != rhs_job->runtime) {
+    return lhs_job->runtime < rhs_job->runtime ? -1 : 1;
   }
+  return (lhs_job->pid > rhs_job->pid) - (lhs_job->pid < rhs_job->pid);
 }
 
-void rr_statistics(Job *joblist, int jobnum, int time_slice) {
-  srand((unsigned int)time(NULL));
-  // Initialize the turnaround time of each process
-  int *turnaround_time = (int *)malloc(sizeof(int) * jobnum);
-  memset(turnaround_time, 0, sizeof(int) * jobnum);
+void sjf_sort(Job *joblist, int jobnum) { qsort(joblist, jobnum, sizeof(Job), compare_runtime); }
 
-  // Initialize the response time of each process
-  int *response_time = (int *)malloc(sizeof(int) * jobnum);
-  memset(response_time, -1, sizeof(int) * jobnum);
+// Reversed, so the job with the least remaining runtime is on top of the max-heap. Ties go to the earliest arrival.
+static int compare_remaining(Job *const *lhs, Job *const *rhs) {
+  const Job *lhs_job = *lhs;
+  const Job *rhs_job = *rhs;
+  if (lhs_job->remaining != rhs_job->remaining) {
+    return lhs_job->remaining > rhs_job->remaining ? -1 : 1;
+  }
+  if (lhs_job->arrival != rhs_job->arrival) {
+    return lhs_job->arrival > rhs_job->arrival ? -1 : 1;
+  }
+  return (lhs_job->pid < rhs_job->pid) - (lhs_job->pid > rhs_job->pid);
+}
 
-  int currtime = 0;    // Current time of execution
-  int round_time = 0;  // Current round time
+#define i_type JobHeap
+#define i_key Job *
+#define i_cmp compare_remaining
+#include "stc/cpque.h"
+
+// Runs the ready job with the least remaining runtime, each job to completion for SJF. STCF preempts the running job
+// as soon as a job that needs less arrives.
+typedef struct ShortestFirst {
+  JobHeap ready;
+  bool preemptive;
+} ShortestFirst;
+
+static void shortest_ready(void *policy, Job *job, ReadyReason reason, int64_t now) {
+  (void)reason;
+  (void)now;
+  JobHeap_push(&((ShortestFirst *)policy)->ready, job);
+}
 
-  //  Initialize the queue of processes
-  JobDeque jobs = JobDeque_init();
-  for (int i = 0; i < jobnum; i++) {
-    JobDeque_push(&jobs, &joblist[i]);
+static Job *shortest_dispatch(void *policy, int64_t now, int64_t *slice) {
+  (void)now;
+  ShortestFirst *shortest = (ShortestFirst *)policy;
+  if (JobHeap_empty(&shortest->ready)) {
+    return NULL;
   }
+  Job *job = *JobHeap_top(&shortest->ready);
+  JobHeap_pop(&shortest->ready);
+  *slice = 0;
+  return job;
+}
 
-  while (!JobDeque_empty(&jobs)) {
-    Job *job = *JobDeque_front(&jobs);  // Get the first process in the queue
-    JobDeque_pop_front(&jobs);          // Pop the process from the queue
+static bool shortest_preempt(void *policy, const Job *running, int64_t remaining) {
+  (void)running;
+  const ShortestFirst *shortest = (const ShortestFirst *)policy;
+  return shortest->preemptive && !JobHeap_empty(&shortest->ready) &&
+         (*JobHeap_top(&shortest->ready))->remaining < remaining;
+}
 
-    int pid = job->pid;
-    int runtime = job->runtime;
-    if (response_time[pid] == -1) {
-      response_time[pid] = currtime;
-    }
-    // If process can't be finished in the current time slice
-    if (runtime > time_slice) {
-      int is_yield = rand() % 10;  // 10% chance of yielding to simulate I/O
-      if (is_yield == 0) {
-        // If current process yield. To make life easier, when it runs half of the current time slice, it will yield
-        job->runtime = job->runtime - time_slice / 2;
-        round_time = time_slice / 2;
-        printf("[time %6d ] Run process %d for %d secs\n", currtime, pid, round_time);
-        printf("process %d yields\n", job->pid);
-        // Push the process to the tail of the queue
-        JobDeque_push_back(&jobs, job);
-      } else {
-        // Current process doesn't yield
-        round_time = time_slice;
-        printf("[time %6d ] Run process %d for %d secs\n", currtime, pid, round_time);
-        // Push the process to the tail of the queue
-        JobDeque_push_back(&jobs, job);
-      }
+static const SchedulerOps shortest_ops = {
+    .ready = shortest_ready, .dispatch = shortest_dispatch, .burst_done = rr_burst_done, .preempt = shortest_preempt};
+
+void stcf_statistics(Job *joblist, int jobnum, const RunOptions *options) {
+  run_joblist(joblist, jobnum, STCF, 0, 0, 0, options);
+}
+
+void rr_statistics(Job *joblist, int jobnum, int time_slice, const RunOptions *options) {
+  run_joblist(joblist, jobnum, RR, time_slice, 0, 0, options);
+}
+
+static void job_list_push(JobList *list, Job *job) {
+  job->next = NULL;
+  if (list->tail == NULL) {
+    list->head = job;
+  } else {
+    list->tail->next = job;
+  }
+  list->tail = job;
+}
+
+static Job *job_list_pop(JobList *list) {
+  Job *job = list->head;
+  list->head = job->next;
+  if (list->head == NULL) {
+    list->tail = NULL;
+  }
+  return job;
+}
+
+// Move every process of other to the tail of list
+static void job_list_splice(JobList *list, JobList *other) {
+  if (other->head == NULL) {
+    return;
+  }
+  if (list->tail == NULL) {
+    list->head = other->head;
+  } else {
+    list->tail->next = other->head;
+  }
+  list->tail = other->tail;
+  other->head = NULL;
+  other->tail = NULL;
+}
+
+// Picking a queue and boosting take constant time whatever the number of processes. Bit i of nonempty is set while
+// queue i holds a process, so the highest non-empty queue is its lowest set bit. A boost splices the lower queues onto
+// the highest one and starts a new epoch, a process that was off the queues during a boost finds its epoch outdated
+// once it is ready again and starts over in the highest queue.
+typedef struct Mlfq {
+  JobList *queues;
+  unsigned int queue_num;
+  uint64_t nonempty;
+  int *time_slices;
+  int boost;
+  int round;
+  uint32_t epoch;     // Boosts so far
+  int running_level;  // The queue and round the process on the CPU was picked in
+  int running_round;
+  bool quiet;  // Don't print the boosts
+} Mlfq;
+
+static void mlfq_ready(void *policy, Job *job, ReadyReason reason, int64_t now) {
+  (void)now;
+  Mlfq *mlfq = (Mlfq *)policy;
+  if (reason == READY_ARRIVED || job->epoch != mlfq->epoch) {
+    // New processes and processes boosted while they waited for I/O start in the highest priority queue
+    job->priority = 0;
+  } else if (reason == READY_EXPIRED && job->priority != mlfq->queue_num - 1) {
+    // A process that used up its time slice moves down a queue, unless it is in the lowest priority queue
+    job->priority += 1;
+  }
+  job->epoch = mlfq->epoch;
+  job_list_push(&mlfq->queues[job->priority], job);
+  mlfq->nonempty |= UINT64_C(1) << job->priority;
+}
+
+static Job *mlfq_dispatch(void *policy, int64_t now, int64_t *slice) {
+  (void)now;
+  Mlfq *mlfq = (Mlfq *)policy;
+  // Find the highest non-empty queue
+  int index = find_queue(mlfq->nonempty);
+  if (index == -1) {
+    return NULL;
+  }
+
+  // Splice all queues (except high queue) onto the high queue, in the order of their priority
+  if (mlfq->boost > 0 && mlfq->round != 0 && mlfq->round % mlfq->boost == 0) {
+    if (!mlfq->quiet) {
+      printf("[ Round %d ] BOOST (every %d)\n", mlfq->round, mlfq->boost);
     }
-    // Process can be finished in the current time slice
-    else {
-      round_time = runtime;
-      turnaround_time[pid] = currtime + round_time;
-      printf("[time %6d ] Run process %d for %d secs (Finished at %d)\n", currtime, pid, round_time,
-             currtime + round_time);
+    for (uint64_t lower = mlfq->nonempty & ~UINT64_C(1); lower != 0; lower &= lower - 1) {
+      job_list_splice(&mlfq->queues[0], &mlfq->queues[find_queue(lower)]);
     }
-    currtime += round_time;
+    mlfq->nonempty = 1;
+    mlfq->epoch++;
+    index = 0;
   }
 
-  printf("\nFinal Statistics:\n");
-  int turnaroundSum = 0, responseSum = 0;
-  for (int i = 0; i < jobnum; i++) {
-    printf("Process %3d -- Response: %6d, Turnaround: %6d\n", joblist[i].pid, response_time[i], turnaround_time[i]);
-    responseSum += response_time[i];
-    turnaroundSum += turnaround_time[i];
+  // Get the first process of the queue
+  JobList *curr_queue = &mlfq->queues[index];
+  Job *job = job_list_pop(curr_queue);
+  if (curr_queue->head == NULL) {
+    mlfq->nonempty &= ~(UINT64_C(1) << index);
   }
-  printf("\nAverage Response: %6d, Average Turnaround: %6d\n", responseSum / jobnum, turnaroundSum / jobnum);
+  // A process boosted while it waited in a lower queue runs at the priority of the queue it is in now
+  job->priority = index;
+  job->epoch = mlfq->epoch;
+  *slice = mlfq->time_slices[index];
+  mlfq->running_level = index;
+  mlfq->running_round = mlfq->round++;
+  return job;
+}
 
-  // Free the memory to avoid memory leak
-  JobDeque_drop(&jobs);
-  free(turnaround_time);
-  free(response_time);
+static void mlfq_burst_done(void *policy, const Burst *burst) {
+  const Mlfq *mlfq = (const Mlfq *)policy;
+  const long long length = burst->length;
+  if (burst->end == BURST_FINISHED) {
+    printf("[Round %d ] Run process %d at priority %d for %lld secs (finished at %lld)\n", mlfq->running_round,
+           burst->job->pid, mlfq->running_level, length, (long long)burst->start + length);
+    return;
+  }
+  printf("[Round %d ] Run process %d at priority %d for %lld secs\n", mlfq->running_round, burst->job->pid,
+         mlfq->running_level, length);
+  if (burst->end == BURST_YIELDED) {
+    printf("process %d yields\n", burst->job->pid);
+  }
 }
 
-void mlfq_statistics(Job *joblist, int jobnum, int numQueues, int time_slice, int boost) {
-  srand((unsigned int)time(NULL));
-  int finished_jobs = 0;
-  int round = 0;
-  int index = -1;
-  int currtime = 0;
-  JobDeque *queue = NULL;
-  // Initialize the array of queues
-  int *time_slices = (int *)malloc(sizeof(int) * numQueues);
-  time_slices[0] = time_slice;
+static const SchedulerOps mlfq_ops = {.ready = mlfq_ready, .dispatch = mlfq_dispatch, .burst_done = mlfq_burst_done};
 
+static void mlfq_init(Mlfq *mlfq, int numQueues, int time_slice, int boost) {
+  if (numQueues < 1 || numQueues > MLFQ_MAX_QUEUES) {
+    fprintf(stderr, "Invalid number of queues: %d, MLFQ takes 1 to %d queues\n", numQueues, MLFQ_MAX_QUEUES);
+    exit(EXIT_FAILURE);
+  }
+  mlfq->queue_num = numQueues;
+  mlfq->nonempty = 0;
+  mlfq->boost = boost;
+  mlfq->round = 0;
+  mlfq->epoch = 0;
+  mlfq->quiet = false;
   // Initialize the time slice size for each queue
+  mlfq->time_slices = (int *)malloc(sizeof(int) * numQueues);
+  mlfq->time_slices[0] = time_slice;
   for (int i = 1; i < numQueues; i++) {
-    time_slices[i] = time_slices[i - 1] + 500;
+    mlfq->time_slices[i] = mlfq->time_slices[i - 1] + 500;
   }
-
-  // Initialize the response time of each process
-  int *response_times = (int *)malloc(sizeof(int) * jobnum);
-  memset(response_times, -1, sizeof(int) * jobnum);
-
-  // Initialize the turnaround time of each process
-  int *turnaround_times = (int *)malloc(sizeof(int) * jobnum);
-  memset(turnaround_times, 0, sizeof(int) * jobnum);
-
   // Initialize the multilevel queues
-  VecDeque queues = VecDeque_init();
-  for (int i = 0; i < numQueues; i++) {
-    // Avoid stack-use-after-scope
-    queue = VecDeque_push_back(&queues, JobDeque_init());
-  }
+  mlfq->queues = (JobList *)calloc(numQueues, sizeof(JobList));
+}
 
-  // Add all jobs to the highest priority queue
-  queue = VecDeque_at_mut(&queues, 0);
-  for (int i = 0; i < jobnum; i++) {
-    JobDeque_push(queue, &joblist[i]);
-  }
-
-  while (finished_jobs < jobnum) {
-    // remove all jobs from queues (except high queue) and put them in high queue
-    if (boost > 0 && round != 0) {
-      if (round % boost == 0) {
-        // Ignore the boost time
-        printf("[ Round %d ] BOOST (every %d)\n", round, boost);
-        JobDeque *high_queue = VecDeque_at_mut(&queues, 0);
-        for (int i = 1; i < numQueues; i++) {
-          // Get the rest of queues
-          JobDeque *temp = VecDeque_at_mut(&queues, i);
-          while (!JobDeque_empty(temp)) {
-            // Add the job to the highest priority queue
-            JobDeque_push(high_queue, *JobDeque_front(temp));
-            JobDeque_pop_front(temp);
-          }
-        }
-      }
-    }
+static void mlfq_drop(Mlfq *mlfq) {
+  free(mlfq->queues);
+  free(mlfq->time_slices);
+}
 
-    // Find the highest non-empty queue
-    index = find_queue(&queues);
-    if (index == -1) {
-      // Ignore CPU idle time
-      printf("[Round %d ] No jobs can be executed\n", round);
-      round += 1;
-      continue;
-    }
-    // Get the first process of the queue
-    JobDeque *curr_queue = VecDeque_at_mut(&queues, index);
-    Job *job = *JobDeque_front(curr_queue);
-    JobDeque_pop_front(curr_queue);
+void mlfq_statistics(Job *joblist, int jobnum, int numQueues, int time_slice, int boost, const RunOptions *options) {
+  run_joblist(joblist, jobnum, MLFQ, time_slice, numQueues, boost, options);
+}
 
-    if (response_times[job->pid] == -1) {
-      response_times[job->pid] = currtime;
-    }
+// A quiet run leaves out the line every policy prints for a burst
+static void run_simulator(Simulator *sim, void *policy, SchedulerOps ops, bool quiet) {
+  if (quiet) {
+    ops.burst_done = NULL;
+  }
+  sim_run(sim, policy, &ops);
+}
 
-    // Current process can't be finished in the current time slice
-    if (job->runtime > (unsigned int)time_slices[index]) {
-      int is_yield = rand() % 10;  // 10% chance of yielding to simulate I/O
-      if (is_yield == 0) {
-        // If current process yield. To make life easier, when it runs half of the current time slice, it will yield
-        currtime += time_slices[index] / 2;
-        job->runtime -= time_slices[index] / 2;
-        printf("[Round %d ] Run process %d at priority %d for %d secs\n", round, job->pid, index,
-               time_slices[index] / 2);
-        printf("process %d yields\n", job->pid);
-        JobDeque_push(VecDeque_at_mut(&queues, index), job);
-      } else {
-        // Current process doesn't yield
-        printf("[Round %d ] Run process %d at priority %d for %d secs\n", round, job->pid, index, time_slices[index]);
-        // Current process is not in the lowest priority queue
-        if (index != numQueues - 1) {
-          currtime += time_slices[index];
-          job->runtime -= time_slices[index];
-          JobDeque_push(VecDeque_at_mut(&queues, index + 1), job);
-        } else {
-          // Current process is in the lowest priority queue
-          currtime += time_slices[index];
-          job->runtime -= time_slices[index];
-          JobDeque_push(VecDeque_at_mut(&queues, index), job);
-        }
-      }
-    } else {
-      // Current process can be finished in the current time slice
-      currtime += job->runtime;
-      turnaround_times[job->pid] = currtime += job->runtime;
-      printf("[Round %d ] Run process %d at priority %d for %d secs (finished at %d)\n", round, job->pid, index,
-             job->runtime, currtime);
-      finished_jobs++;
-    }
-    round++;
+// Run the jobs of a simulator under a policy
+static void run_policy(Simulator *sim, Policy policy, int time_slice, int numQueues, int boost,
+                       const RunOptions *options) {
+  sim_set_log(sim, options->log);
+  switch (policy) {
+    case SJF:
+    case STCF: {
+      ShortestFirst shortest = {.ready = JobHeap_init(), .preemptive = policy == STCF};
+      run_simulator(sim, &shortest, shortest_ops, options->quiet);
+      JobHeap_drop(&shortest.ready);
+    } break;
+    case FIFO:
+    case RR: {
+      RoundRobin rr = {.ready = JobDeque_init(), .time_slice = policy == RR ? time_slice : 0};
+      run_simulator(sim, &rr, rr_ops, options->quiet);
+      JobDeque_drop(&rr.ready);
+    } break;
+    case MLFQ: {
+      Mlfq mlfq;
+      mlfq_init(&mlfq, numQueues, time_slice, boost);
+      mlfq.quiet = options->quiet;
+      run_simulator(sim, &mlfq, mlfq_ops, options->quiet);
+      mlfq_drop(&mlfq);
+    } break;
   }
+}
 
-  printf("\nFinal Statistics:\n");
-  int turnaroundSum = 0, responseSum = 0;
+// Run the jobs of the list under a policy, 1/10 chance of yielding to simulate I/O and I/O takes no time
+static void run_joblist(Job *joblist, int jobnum, Policy policy, int time_slice, int numQueues, int boost,
+                        const RunOptions *options) {
+  Simulator *sim = sim_init(jobnum, 10, 0);
   for (int i = 0; i < jobnum; i++) {
-    printf("Process %3d -- Response: %6d, Turnaround: %6d\n", joblist[i].pid, response_times[joblist[i].pid],
-           turnaround_times[joblist[i].pid]);
-    responseSum += response_times[joblist[i].pid];
-    turnaroundSum += turnaround_times[joblist[i].pid];
+    sim_add_job(sim, &joblist[i]);
+  }
+  run_policy(sim, policy, time_slice, numQueues, boost, options);
+  if (options->quiet) {
+    sim_print_summary(sim);
+  } else {
+    sim_print_statistics(sim, joblist, jobnum);
   }
-  printf("\nAverage Response: %6d, Average Turnaround: %6d\n", responseSum / jobnum, turnaroundSum / jobnum);
+  sim_destroy(sim);
+}
 
-  c_drop(VecDeque, &queues);
-  free(time_slices);
-  free(response_times);
-  free(turnaround_times);
+void open_statistics(const struct JobSource *source, Policy policy, int time_slice, int numQueues, int boost,
+                     const RunOptions *options) {
+  Simulator *sim = sim_init(0, 10, 0);
+  sim_set_source(sim, *source);
+  run_policy(sim, policy, time_slice, numQueues, boost, options);
+  sim_print_summary(sim);
+  sim_destroy(sim);
 }
 
 /**
  * @brief Find the highest non-empty queue index
  *
- * @param queues
- * @return JobDeque*, return -1 if all queues are empty
+ * @param nonempty the queues that hold a process, bit i for queue i
+ * @return int, return -1 if all queues are empty
  */
-int find_queue(VecDeque *queues) {
-  for (int i = 0; i < VecDeque_size(queues); i++) {
-    // Check whether current queue is empty
-    const JobDeque *high_queue = VecDeque_at(queues, i);
-    if (!JobDeque_empty(high_queue)) {
-      return i;
-    }
+int find_queue(uint64_t nonempty) {
+  if (nonempty == 0) {
+    return -1;
+  }
+#if defined __GNUC__ || defined __clang__
+  return __builtin_ctzll(nonempty);
+#else
+  int index = 0;
+  for (; (nonempty & 1) == 0; nonempty >>= 1) {
+    index++;
   }
-  return -1;
+  return index;
+#endif
 }
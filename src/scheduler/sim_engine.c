@@ -0,0 +1,242 @@
+#include "scheduler/sim_engine.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "scheduler.h"
+#include "scheduler/event_log.h"
+
+//===----------------------------------------------------------------------===//
+// Simulation Engine Implementation
+//===----------------------------------------------------------------------===//
+Simulator *sim_init(size_t job_num, int yield_chance, int64_t io_time) {
+  Simulator *sim = (Simulator *)malloc(sizeof(Simulator));
+  sim->events_ = SimEventHeap_init();
+  sim->sequence_ = 0;
+  sim->now_ = 0;
+  sim->burst_.job = NULL;
+  sim->yield_chance_ = yield_chance;
+  sim->io_time_ = io_time;
+  sim->log_ = NULL;
+  sim->source_ = (JobSource){.next = NULL, .state = NULL};
+  sim->jobs_ = JobStack_init();
+  sim->free_jobs_ = JobStack_init();
+  sim->job_num_ = job_num;
+  sim->finished_num_ = 0;
+  sim->busy_time_ = 0;
+  sim->response_sum_ = 0;
+  sim->turnaround_sum_ = 0;
+  sim->max_turnaround_ = 0;
+  sim->responses_ = (int64_t *)malloc(sizeof(int64_t) * (job_num == 0 ? 1 : job_num));
+  sim->turnarounds_ = (int64_t *)malloc(sizeof(int64_t) * (job_num == 0 ? 1 : job_num));
+  for (size_t pid = 0; pid < job_num; ++pid) {
+    sim->responses_[pid] = -1;
+    sim->turnarounds_[pid] = 0;
+  }
+  return sim;
+}
+
+void sim_destroy(Simulator *sim) {
+  SimEventHeap_drop(&sim->events_);
+  c_foreach(job, JobStack, sim->jobs_) {
+    free(*job.ref);
+  }
+  JobStack_drop(&sim->jobs_);
+  JobStack_drop(&sim->free_jobs_);
+  free(sim->responses_);
+  free(sim->turnarounds_);
+  free(sim);
+}
+
+// Schedule an event and return its sequence
+static uint64_t sim_schedule(Simulator *sim, int64_t time, SimEventKind kind, Job *job) {
+  SimEvent event = {.time = time, .sequence = sim->sequence_++, .kind = kind, .job = job};
+  SimEventHeap_push(&sim->events_, event);
+  return event.sequence;
+}
+
+void sim_add_job(Simulator *sim, Job *job) {
+  job->remaining = job->runtime;
+  job->first_run = -1;
+  sim_schedule(sim, job->arrival, SIM_ARRIVAL, job);
+}
+
+// Schedule the arrival of the next job of the source
+static void sim_pull(Simulator *sim) {
+  Job *job = NULL;
+  if (JobStack_empty(&sim->free_jobs_)) {
+    job = (Job *)malloc(sizeof(Job));
+    JobStack_push(&sim->jobs_, job);
+  } else {
+    job = *JobStack_back(&sim->free_jobs_);
+    JobStack_pop(&sim->free_jobs_);
+  }
+  if (!sim->source_.next(sim->source_.state, job)) {
+    JobStack_push(&sim->free_jobs_, job);
+    sim->source_.next = NULL;
+    return;
+  }
+  if (job->arrival < sim->now_) {
+    fprintf(stderr, "Job %u arrives at %lld, before the previous one\n", job->pid, (long long)job->arrival);
+    exit(EXIT_FAILURE);
+  }
+  sim_add_job(sim, job);
+}
+
+void sim_set_log(Simulator *sim, struct EventLog *log) { sim->log_ = log; }
+
+void sim_set_source(Simulator *sim, JobSource source) {
+  sim->source_ = source;
+  if (sim->source_.next != NULL) {
+    sim_pull(sim);
+  }
+}
+
+// Put the job the policy picks on the CPU and schedule the end of its burst
+static void sim_dispatch(Simulator *sim, void *policy, const SchedulerOps *ops) {
+  int64_t slice = 0;
+  Job *job = ops->dispatch(policy, sim->now_, &slice);
+  if (job == NULL) {
+    return;
+  }
+  if (job->first_run == -1) {
+    job->first_run = sim->now_;
+  }
+
+  Burst burst = {.job = job, .start = sim->now_, .length = job->remaining, .end = BURST_FINISHED};
+  if (slice > 0 && job->remaining > slice) {
+    // To make life easier, a job that yields does so when it ran half of its slice
+    if (sim->yield_chance_ > 0 && rand() % sim->yield_chance_ == 0) {
+      burst.length = slice / 2;
+      burst.end = BURST_YIELDED;
+    } else {
+      burst.length = slice;
+      burst.end = BURST_EXPIRED;
+    }
+  }
+  sim->burst_ = burst;
+  sim->burst_event_ = sim_schedule(sim, sim->now_ + burst.length, SIM_BURST_END, job);
+}
+
+static void sim_finish(Simulator *sim, const Job *job) {
+  const int64_t response = job->first_run - job->arrival;
+  const int64_t turnaround = sim->now_ - job->arrival;
+  if (job->pid < sim->job_num_) {
+    sim->responses_[job->pid] = response;
+    sim->turnarounds_[job->pid] = turnaround;
+  }
+  sim->finished_num_++;
+  sim->response_sum_ += response;
+  sim->turnaround_sum_ += turnaround;
+  if (turnaround > sim->max_turnaround_) {
+    sim->max_turnaround_ = turnaround;
+  }
+}
+
+// Take the job off the CPU, its burst ran until now
+static void sim_end_burst(Simulator *sim, void *policy, const SchedulerOps *ops) {
+  const Burst burst = sim->burst_;
+  sim->burst_.job = NULL;
+  sim->busy_time_ += burst.length;
+  burst.job->remaining -= burst.length;
+  if (burst.end == BURST_FINISHED) {
+    sim_finish(sim, burst.job);
+  }
+  if (sim->log_ != NULL) {
+    event_log_write(sim->log_, &burst);
+  }
+  if (ops->burst_done != NULL) {
+    ops->burst_done(policy, &burst);
+  }
+  switch (burst.end) {
+    case BURST_FINISHED:
+      if (!JobStack_empty(&sim->jobs_)) {
+        // The job came from the source and nobody holds it anymore
+        JobStack_push(&sim->free_jobs_, burst.job);
+      }
+      break;
+    case BURST_EXPIRED:
+      ops->ready(policy, burst.job, READY_EXPIRED, sim->now_);
+      break;
+    case BURST_YIELDED:
+      sim_schedule(sim, sim->now_ + sim->io_time_, SIM_IO_DONE, burst.job);
+      break;
+    case BURST_PREEMPTED:
+      ops->ready(policy, burst.job, READY_PREEMPTED, sim->now_);
+      break;
+  }
+}
+
+static void sim_handle(Simulator *sim, const SimEvent *event, void *policy, const SchedulerOps *ops) {
+  switch (event->kind) {
+    case SIM_ARRIVAL:
+      // Only the arrival of a job brings in the next one of the source, the jobs waiting in the heap stay few
+      if (sim->source_.next != NULL) {
+        sim_pull(sim);
+      }
+      ops->ready(policy, event->job, READY_ARRIVED, sim->now_);
+      break;
+    case SIM_BURST_END:
+      if (sim->burst_.job != NULL && event->sequence == sim->burst_event_) {
+        sim_end_burst(sim, policy, ops);
+      }
+      break;
+    case SIM_IO_DONE:
+      ops->ready(policy, event->job, READY_YIELDED, sim->now_);
+      break;
+  }
+}
+
+void sim_run(Simulator *sim, void *policy, const SchedulerOps *ops) {
+  while (!SimEventHeap_empty(&sim->events_)) {
+    sim->now_ = SimEventHeap_top(&sim->events_)->time;
+    // Handle every event of this instant before picking the next job, the CPU stays idle if none is ready
+    while (!SimEventHeap_empty(&sim->events_) && SimEventHeap_top(&sim->events_)->time == sim->now_) {
+      const SimEvent event = *SimEventHeap_top(&sim->events_);
+      SimEventHeap_pop(&sim->events_);
+      sim_handle(sim, &event, policy, ops);
+    }
+    if (sim->burst_.job != NULL && ops->preempt != NULL) {
+      Burst *burst = &sim->burst_;
+      const int64_t ran = sim->now_ - burst->start;
+      if (ops->preempt(policy, burst->job, burst->job->remaining - ran)) {
+        // Its end event stays in the heap and is skipped once it comes up
+        burst->length = ran;
+        burst->end = BURST_PREEMPTED;
+        sim_end_burst(sim, policy, ops);
+      }
+    }
+    if (sim->burst_.job == NULL) {
+      sim_dispatch(sim, policy, ops);
+    }
+  }
+}
+
+void sim_print_statistics(const Simulator *sim, const Job *joblist, int jobnum) {
+  printf("\nFinal Statistics:\n");
+  long long responseSum = 0, turnaroundSum = 0;
+  for (int i = 0; i < jobnum; i++) {
+    const long long response = sim->responses_[joblist[i].pid];
+    const long long turnaround = sim->turnarounds_[joblist[i].pid];
+    printf("Process %3d -- Response: %6lld, Turnaround: %6lld\n", joblist[i].pid, response, turnaround);
+    responseSum += response;
+    turnaroundSum += turnaround;
+  }
+  if (jobnum > 0) {
+    printf("\nAverage Response: %6lld, Average Turnaround: %6lld\n", responseSum / jobnum, turnaroundSum / jobnum);
+  }
+}
+
+void sim_print_summary(const Simulator *sim) {
+  printf("\nSummary Statistics:\n");
+  if (sim->finished_num_ == 0) {
+    printf("No jobs finished\n");
+    return;
+  }
+  const double finished_num = (double)sim->finished_num_;
+  printf("Jobs: %zu, Average Response: %.1f, Average Turnaround: %.1f, Max Turnaround: %lld\n", sim->finished_num_,
+         (double)sim->response_sum_ / finished_num, (double)sim->turnaround_sum_ / finished_num,
+         (long long)sim->max_turnaround_);
+  printf("Elapsed: %lld, CPU Utilization: %.4f\n", (long long)sim->now_,
+         sim->now_ > 0 ? (double)sim->busy_time_ / (double)sim->now_ : 0.0);
+}
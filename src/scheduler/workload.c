@@ -0,0 +1,179 @@
+#include "scheduler/workload.h"
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "scheduler.h"
+
+//===----------------------------------------------------------------------===//
+// Distribution Implementation
+//===----------------------------------------------------------------------===//
+bool parse_distribution(const char *spec, Distribution *dist) {
+  static const struct {
+    const char *name;
+    DistributionKind kind;
+    int param_num;
+  } kinds[] = {{"const", DIST_CONSTANT, 1},
+               {"uniform", DIST_UNIFORM, 2},
+               {"exp", DIST_EXPONENTIAL, 1},
+               {"pareto", DIST_PARETO, 2},
+               {"bimodal", DIST_BIMODAL, 3}};
+
+  const char *colon = strchr(spec, ':');
+  if (colon == NULL) {
+    return false;
+  }
+  for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); ++i) {
+    if (strlen(kinds[i].name) != (size_t)(colon - spec) || strncmp(spec, kinds[i].name, colon - spec) != 0) {
+      continue;
+    }
+    dist->kind = kinds[i].kind;
+    const char *param = colon + 1;
+    for (int j = 0; j < kinds[i].param_num; ++j) {
+      char *end = NULL;
+      dist->param[j] = strtod(param, &end);
+      // Every parameter is a number followed by a colon, but the last one ends the spec
+      if (end == param || !isfinite(dist->param[j]) || dist->param[j] < 0 ||
+          *end != (j + 1 == kinds[i].param_num ? '\0' : ':')) {
+        return false;
+      }
+      param = end + 1;
+    }
+    switch (dist->kind) {
+      case DIST_UNIFORM:
+        return dist->param[0] <= dist->param[1];
+      case DIST_EXPONENTIAL:
+        return dist->param[0] > 0;
+      case DIST_PARETO:
+        return dist->param[0] > 0 && dist->param[1] > 0;
+      case DIST_BIMODAL:
+        return dist->param[2] <= 1;
+      default:
+        return true;
+    }
+  }
+  return false;
+}
+
+double sample_distribution(const Distribution *dist, crand_t *rng) {
+  const double *param = dist->param;
+  switch (dist->kind) {
+    case DIST_CONSTANT:
+      return param[0];
+    case DIST_UNIFORM:
+      return param[0] + (param[1] - param[0]) * crand_f64(rng);
+    case DIST_EXPONENTIAL:
+      // Inverse transform sampling, 1 - u is in (0, 1] so the log is finite
+      return -param[0] * log(1.0 - crand_f64(rng));
+    case DIST_PARETO:
+      return param[1] / pow(1.0 - crand_f64(rng), 1.0 / param[0]);
+    case DIST_BIMODAL:
+      return crand_f64(rng) < param[2] ? param[1] : param[0];
+  }
+  return 0.0;
+}
+
+double distribution_mean(const Distribution *dist) {
+  const double *param = dist->param;
+  switch (dist->kind) {
+    case DIST_CONSTANT:
+      return param[0];
+    case DIST_UNIFORM:
+      return (param[0] + param[1]) / 2;
+    case DIST_EXPONENTIAL:
+      return param[0];
+    case DIST_PARETO:
+      return param[0] > 1 ? param[0] * param[1] / (param[0] - 1) : INFINITY;
+    case DIST_BIMODAL:
+      return (1 - param[2]) * param[0] + param[2] * param[1];
+  }
+  return 0.0;
+}
+
+//===----------------------------------------------------------------------===//
+// Workload Implementation
+//===----------------------------------------------------------------------===//
+Workload *workload_init(Distribution interarrival, Distribution service, uint64_t seed, size_t job_limit,
+                        int64_t horizon) {
+  Workload *workload = (Workload *)malloc(sizeof(Workload));
+  workload->interarrival_ = interarrival;
+  workload->service_ = service;
+  workload->rng_ = crand_init(seed);
+  workload->trace_ = NULL;
+  workload->clock_ = 0.0;
+  workload->next_pid_ = 0;
+  workload->job_limit_ = job_limit;
+  workload->horizon_ = horizon;
+  return workload;
+}
+
+Workload *workload_open_trace(const char *path, size_t job_limit, int64_t horizon) {
+  FILE *trace = fopen(path, "r");
+  if (trace == NULL) {
+    return NULL;
+  }
+  Distribution none = {.kind = DIST_CONSTANT, .param = {0}};
+  Workload *workload = workload_init(none, none, 0, job_limit, horizon);
+  workload->trace_ = trace;
+  return workload;
+}
+
+void workload_destroy(Workload *workload) {
+  if (workload->trace_ != NULL) {
+    fclose(workload->trace_);
+  }
+  free(workload);
+}
+
+// Read the arrival and runtime of the next job of the trace, false at its end
+static bool workload_read_trace(Workload *workload, int64_t *arrival, unsigned int *runtime) {
+  char line[256];
+  while (fgets(line, sizeof(line), workload->trace_) != NULL) {
+    const char *begin = line + strspn(line, " \t");
+    if (*begin == '#' || *begin == '\n' || *begin == '\r' || *begin == '\0') {
+      continue;
+    }
+    long long time = 0;
+    unsigned long long length = 0;
+    if (sscanf(begin, "%lld %llu", &time, &length) != 2 || time < 0 || length > UINT_MAX) {
+      fprintf(stderr, "Invalid trace line: %s", line);
+      exit(EXIT_FAILURE);
+    }
+    *arrival = time;
+    *runtime = (unsigned int)length;
+    return true;
+  }
+  return false;
+}
+
+bool workload_next(void *state, Job *job) {
+  Workload *workload = (Workload *)state;
+  if (workload->job_limit_ != 0 && workload->next_pid_ >= workload->job_limit_) {
+    return false;
+  }
+
+  int64_t arrival = 0;
+  unsigned int runtime = 0;
+  if (workload->trace_ != NULL) {
+    if (!workload_read_trace(workload, &arrival, &runtime)) {
+      return false;
+    }
+  } else {
+    workload->clock_ += sample_distribution(&workload->interarrival_, &workload->rng_);
+    const double service = sample_distribution(&workload->service_, &workload->rng_);
+    arrival = workload->clock_ < (double)INT64_MAX ? (int64_t)workload->clock_ : INT64_MAX;
+    runtime = service < (double)UINT_MAX ? (unsigned int)service : UINT_MAX;
+  }
+  if (workload->horizon_ != 0 && arrival > workload->horizon_) {
+    return false;
+  }
+
+  job->pid = workload->next_pid_++;
+  job->runtime = runtime;
+  job->arrival = arrival;
+  return true;
+}
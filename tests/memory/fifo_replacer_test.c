@@ -0,0 +1,82 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "memory/replacer.h"
+
+#define EXPECT(condition)                                                    \
+  do {                                                                       \
+    if (!(condition)) {                                                      \
+      fprintf(stderr, "%s:%d: %s failed\n", __FILE__, __LINE__, #condition); \
+      exit(EXIT_FAILURE);                                                    \
+    }                                                                        \
+  } while (0)
+
+// Fault frames 0 to n - 1 in order and make them evictable
+static FIFOReplacer *fill(size_t n) {
+  FIFOReplacer *replacer = FIFOReplacerInit(n);
+  for (size_t i = 0; i < n; ++i) {
+    FIFOReplacerRecordAccess(replacer, (frame_id_t)i);
+    FIFOReplacerSetEvictable(replacer, (frame_id_t)i, true);
+  }
+  return replacer;
+}
+
+static void expect_victims(FIFOReplacer *replacer, const frame_id_t *victims, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    frame_id_t frame_id = -1;
+    EXPECT(FIFOReplacerEvict(replacer, &frame_id));
+    EXPECT(frame_id == victims[i]);
+  }
+}
+
+static void expect_empty(FIFOReplacer *replacer) {
+  frame_id_t frame_id = -1;
+  EXPECT(FIFOReplacerSize(replacer) == 0);
+  EXPECT(!FIFOReplacerEvict(replacer, &frame_id));
+}
+
+// Pinning and unpinning the oldest frame keeps its place at the head of the queue
+static void test_pin_unpin_oldest(void) {
+  FIFOReplacer *replacer = fill(4);
+  FIFOReplacerSetEvictable(replacer, 0, false);
+  EXPECT(FIFOReplacerSize(replacer) == 3);
+  FIFOReplacerRecordAccess(replacer, 0);
+  FIFOReplacerSetEvictable(replacer, 0, true);
+  EXPECT(FIFOReplacerSize(replacer) == 4);
+  expect_victims(replacer, (const frame_id_t[]){0, 1, 2, 3}, 4);
+  expect_empty(replacer);
+  FIFOReplacerDestroy(replacer);
+}
+
+// A pinned frame is skipped, and evicted in its original order once unpinned
+static void test_evict_skips_pinned(void) {
+  FIFOReplacer *replacer = fill(4);
+  FIFOReplacerSetEvictable(replacer, 0, false);
+  FIFOReplacerSetEvictable(replacer, 2, false);
+  expect_victims(replacer, (const frame_id_t[]){1, 3}, 2);
+  expect_empty(replacer);
+  FIFOReplacerSetEvictable(replacer, 2, true);
+  FIFOReplacerSetEvictable(replacer, 0, true);
+  expect_victims(replacer, (const frame_id_t[]){0, 2}, 2);
+  expect_empty(replacer);
+  FIFOReplacerDestroy(replacer);
+}
+
+// An evicted frame faulted again goes to the tail
+static void test_refault_goes_to_tail(void) {
+  FIFOReplacer *replacer = fill(3);
+  expect_victims(replacer, (const frame_id_t[]){0}, 1);
+  FIFOReplacerRecordAccess(replacer, 0);
+  FIFOReplacerSetEvictable(replacer, 0, true);
+  expect_victims(replacer, (const frame_id_t[]){1, 2, 0}, 3);
+  expect_empty(replacer);
+  FIFOReplacerDestroy(replacer);
+}
+
+int main(void) {
+  test_pin_unpin_oldest();
+  test_evict_skips_pinned();
+  test_refault_goes_to_tail();
+  printf("fifo_replacer_test passed\n");
+  return 0;
+}